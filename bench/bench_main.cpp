@@ -0,0 +1,216 @@
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../include/ink/ink.hpp"
+
+// ============================================================================
+// Microbenchmarks. Timings are informational only: nothing here is asserted,
+// so they live outside the test suite. Build with -DINK_BUILD_BENCHMARKS=ON.
+// ============================================================================
+
+#define BENCH(name) INK_LOG << "\n========== " name " =========="
+
+namespace {
+
+int benchThreads()
+{
+    return static_cast<int>(INK_MAX(INK_MIN(std::thread::hardware_concurrency(), 8u), 2u));
+}
+
+// ============================================================================
+// RingBuffer
+// ============================================================================
+void bench_ringbuffer()
+{
+    BENCH("RingBuffer");
+
+    // Small writes: masked (power of two) vs modulo indexing
+    for (size_t cap : {size_t(8192), size_t(8000)}) {
+        ink::RingBuffer ring(cap);
+        constexpr size_t kOps = 2'000'000;
+        char msg[8] = "abcdefg";
+        char out[8];
+        size_t sink = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < kOps; ++i) {
+            sink += ring.write(msg, sizeof(msg));
+            sink += ring.read(out, sizeof(out));
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        INK_LOG << "capacity " << cap << " 8-byte write+read " << elapsed.count() / kOps << " ns/op"
+                << (sink == kOps * 16 ? "" : " (short I/O!)");
+    }
+}
+
+// ============================================================================
+// SpscRingBuffer
+// ============================================================================
+void bench_spscringbuffer()
+{
+    BENCH("SpscRingBuffer");
+
+    // Two-thread streaming throughput through the zero-copy buffers
+    constexpr size_t kTotal = size_t(256) << 20;
+    constexpr size_t kChunk = 4096;
+    std::vector<char> pattern(kChunk);
+    for (size_t i = 0; i < pattern.size(); ++i) pattern[i] = static_cast<char>(i & 0xFF);
+
+    ink::SpscRingBuffer pipe(size_t(64) << 10, ink::SpscRingBuffer::Blocking);
+    auto start = std::chrono::steady_clock::now();
+    std::thread producer([&]() {
+        size_t sent = 0;
+        while (sent < kTotal) {
+            size_t space = 0;
+            char* dst = pipe.getWriteBuffer(space);
+            if (!dst) {
+                pipe.waitForSpace();
+                continue;
+            }
+            const size_t n = std::min({space, kChunk, kTotal - sent});
+            memcpy(dst, pattern.data(), n);
+            pipe.advanceWritePos(n);
+            sent += n;
+        }
+        pipe.close();
+    });
+    size_t received = 0;
+    while (pipe.waitForData()) {
+        size_t n = 0;
+        pipe.getReadBuffer(n);
+        received += n;
+        pipe.advanceReadPos(n);
+    }
+    producer.join();
+    std::chrono::duration<double> secs = std::chrono::steady_clock::now() - start;
+    INK_LOG << (received / secs.count()) / 1e9 << " GB/s";
+}
+
+// ============================================================================
+// ObjectPool / ConcurrentObjectPool
+// ============================================================================
+struct Ticket {
+    u64 owner;
+    u64 seq;
+    Ticket(u64 o, u64 s) : owner(o), seq(s) {}
+};
+
+template<typename Acquire, typename Release>
+double poolBench(int threads, Acquire&& acquire, Release&& release)
+{
+    constexpr int kRounds = 4000;
+    constexpr int kBatch = 64;
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            Ticket* held[kBatch];
+            for (int r = 0; r < kRounds; ++r) {
+                for (int i = 0; i < kBatch; ++i) held[i] = acquire(u64(t), u64(i));
+                for (int i = 0; i < kBatch; ++i) release(held[i]);
+            }
+        });
+    }
+    for (std::thread& w : workers) w.join();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / (double(kRounds) * kBatch);
+}
+
+void bench_objectpool()
+{
+    BENCH("ObjectPool");
+
+    struct Msg { u64 a, b, c, d; };
+    ink::ObjectPool<Msg, 64> msgs;
+    std::vector<Msg*> batch(256);
+    constexpr int kRounds = 20000;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < kRounds; ++r) {
+        for (Msg*& m : batch) m = msgs.acquire();
+        for (Msg* m : batch) msgs.release(m);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    INK_LOG << "acquire+release " << elapsed.count() / (kRounds * batch.size()) << " ns/op";
+}
+
+void bench_concurrent_objectpool()
+{
+    BENCH("ConcurrentObjectPool");
+
+    // Magazines vs a mutex-wrapped ObjectPool vs the heap
+    const int threads = benchThreads();
+    ink::ConcurrentObjectPool<Ticket> magazines;
+    const double magazineNs = poolBench(threads,
+        [&](u64 o, u64 s) { return magazines.acquire(o, s); },
+        [&](Ticket* t) { magazines.release(t); });
+
+    std::mutex poolMutex;
+    ink::ObjectPool<Ticket, 1024> locked;
+    const double mutexNs = poolBench(threads,
+        [&](u64 o, u64 s) { std::lock_guard<std::mutex> lock(poolMutex); return locked.acquire(o, s); },
+        [&](Ticket* t) { std::lock_guard<std::mutex> lock(poolMutex); locked.release(t); });
+
+    const double heapNs = poolBench(threads,
+        [](u64 o, u64 s) { return new Ticket(o, s); },
+        [](Ticket* t) { delete t; });
+
+    INK_LOG << threads << " threads, acquire+release per thread: magazines " << magazineNs
+            << " ns/op, mutex ObjectPool " << mutexNs << " ns/op, new/delete " << heapNs << " ns/op";
+}
+
+// ============================================================================
+// CachePadded
+// ============================================================================
+template<typename Bump>
+double contentionBench(int threads, int perThread, Bump&& bump)
+{
+    std::atomic<int> ready{0};
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            ready++;
+            while (ready.load() < threads) std::this_thread::yield();
+            for (int i = 0; i < perThread; ++i) bump(t);
+        });
+    }
+    for (std::thread& th : workers) th.join();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / (double(threads) * perThread);
+}
+
+void bench_cachepadded()
+{
+    BENCH("CachePadded");
+
+    // Every thread bumping its own counter costs the same as one shared
+    // counter when the counters share a line, and scales once each owns one
+    const int threads = benchThreads();
+    constexpr int kBumps = 200000;
+    std::atomic<u64> shared{0};
+    struct { std::atomic<u64> counters[8]; } adjacent{};
+    ink::CachePadded<std::atomic<u64>> owned[8];
+    ink::ShardedCounter<> sharded;
+    const double sharedNs = contentionBench(threads, kBumps, [&](int) { shared.fetch_add(1, std::memory_order_relaxed); });
+    const double adjacentNs = contentionBench(threads, kBumps, [&](int t) { adjacent.counters[t].fetch_add(1, std::memory_order_relaxed); });
+    const double paddedNs = contentionBench(threads, kBumps, [&](int t) { owned[t]->fetch_add(1, std::memory_order_relaxed); });
+    const double shardedNs = contentionBench(threads, kBumps, [&](int) { sharded.add(); });
+    INK_LOG << threads << " threads, relaxed fetch_add: shared " << sharedNs
+            << " ns/op, adjacent " << adjacentNs << " ns/op, padded " << paddedNs
+            << " ns/op, ShardedCounter " << shardedNs << " ns/op";
+}
+
+}
+
+int main()
+{
+    bench_ringbuffer();
+    bench_spscringbuffer();
+    bench_objectpool();
+    bench_concurrent_objectpool();
+    bench_cachepadded();
+    return 0;
+}
@@ -2,16 +2,98 @@
 #define INK_ALIGNED_ALLOCATOR_HPP
 
 #include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <new>
 #include <limits>
+#include <mutex>
 #include <type_traits>
+#include <unordered_map>
 
 #include "ink/ink_base.hpp"
+#include "ink/PageAllocator.h"
 
 namespace ink {
 
-template<typename T, std::size_t Alignment = 32>
+namespace detail {
+
+// Page-mapped allocator storage. The mapping is exactly the rounded-up
+// request and its length is recomputed from (bytes, pages) on unmap; the
+// grant kind, which a fallback can change per call, is kept in a table
+// keyed by address so the unmap hits the right counter. Only buffers of a
+// page or more come here, so the lookup is small next to the syscall. The
+// caller decides mapped vs heap from the byte count alone, so deallocate
+// needs nothing but (p, n).
+struct MappedGrants {
+    std::mutex mutex;
+    std::unordered_map<void*, PageAllocator::Granted> kinds;
+
+    // Never destroyed: containers with static storage may free after it
+    static MappedGrants& instance()
+    {
+        static MappedGrants* grants = new MappedGrants();
+        return *grants;
+    }
+};
+
+inline void* mapTagged(size_t bytes, PageAllocator::HugePages pages, int node)
+{
+    const PageAllocator::Grant grant = PageAllocator::map(bytes, pages, false, node);
+    if (!grant.memory) throw std::bad_alloc();
+    try {
+        MappedGrants& grants = MappedGrants::instance();
+        std::lock_guard<std::mutex> lock(grants.mutex);
+        grants.kinds.emplace(grant.memory, grant.granted);
+    } catch (...) {
+        PageAllocator::unmap(grant);
+        throw;
+    }
+    return grant.memory;
+}
+
+inline void unmapTagged(void* p, size_t bytes, PageAllocator::HugePages pages) noexcept
+{
+    PageAllocator::Granted granted = PageAllocator::Small;
+    {
+        MappedGrants& grants = MappedGrants::instance();
+        std::lock_guard<std::mutex> lock(grants.mutex);
+        auto it = grants.kinds.find(p);
+        if (it != grants.kinds.end()) {
+            granted = it->second;
+            grants.kinds.erase(it);
+        }
+    }
+    PageAllocator::unmap(PageAllocator::Grant{ p, PageAllocator::roundUp(bytes, pages), granted });
+}
+
+inline void* heapAligned(size_t bytes, size_t alignment)
+{
+    void* ptr = nullptr;
+#if defined(_MSC_VER)
+    ptr = _aligned_malloc(bytes, alignment);
+    if (!ptr) throw std::bad_alloc();
+#else
+    if (posix_memalign(&ptr, alignment, bytes) != 0)
+        throw std::bad_alloc();
+#endif
+    return ptr;
+}
+
+inline void heapFree(void* p) noexcept
+{
+#if defined(_MSC_VER)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+}
+
+// With a Pages policy other than None, allocations of at least one huge
+// page (2 MB) are mapped through PageAllocator instead of posix_memalign;
+// smaller ones keep the heap path.
+template<typename T, std::size_t Alignment = 32, PageAllocator::HugePages Pages = PageAllocator::None>
 class AlignedAllocator {
 public:
     using value_type = T;
@@ -25,7 +107,7 @@ public:
 
     template<class U>
     struct rebind {
-        using other = AlignedAllocator<U, Alignment>;
+        using other = AlignedAllocator<U, Alignment, Pages>;
     };
 
     static_assert((Alignment & (Alignment - 1)) == 0,
@@ -34,11 +116,14 @@ public:
     static_assert(Alignment >= alignof(void*),
                   "Alignment must be >= pointer alignment");
 
+    static_assert(Pages == PageAllocator::None || Alignment <= PageAllocator::kHugePageSize,
+                  "Huge-page mappings are only 2 MB aligned");
+
 public:
     constexpr AlignedAllocator() noexcept = default;
 
     template<class U>
-    constexpr AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+    constexpr AlignedAllocator(const AlignedAllocator<U, Alignment, Pages>&) noexcept {}
 
     // alloc
     [[nodiscard]]
@@ -47,28 +132,28 @@ public:
         if (n > std::numeric_limits<size_type>::max() / sizeof(T))
             throw std::bad_alloc();
 
-        void* ptr = nullptr;
         const size_type bytes = n * sizeof(T);
 
-#if defined(_MSC_VER)
-        ptr = _aligned_malloc(bytes, Alignment);
-        if (!ptr) throw std::bad_alloc();
-#else
-        if (posix_memalign(&ptr, Alignment, bytes) != 0)
-            throw std::bad_alloc();
-#endif
+        if constexpr (Pages != PageAllocator::None) {
+            if (bytes >= PageAllocator::kHugePageSize)
+                return static_cast<pointer>(detail::mapTagged(bytes, Pages, PageAllocator::kNoNode));
+        }
 
-        return static_cast<pointer>(ptr);
+        return static_cast<pointer>(detail::heapAligned(bytes, Alignment));
     }
 
     // dealloc
-    void deallocate(pointer p, size_type) noexcept
+    void deallocate(pointer p, size_type n) noexcept
     {
-#if defined(_MSC_VER)
-        _aligned_free(p);
-#else
-        std::free(p);
-#endif
+        if constexpr (Pages != PageAllocator::None) {
+            const size_type bytes = n * sizeof(T);
+            if (bytes >= PageAllocator::kHugePageSize) {
+                detail::unmapTagged(p, bytes, Pages);
+                return;
+            }
+        }
+
+        detail::heapFree(p);
     }
 
     // cmp
@@ -76,6 +161,91 @@ public:
     constexpr bool operator!=(const AlignedAllocator&) const noexcept { return false; }
 };
 
+// NUMA-placed sibling of AlignedAllocator for large buffers. Requests of at
+// least one page (one huge page with a Pages policy) are mapped and bound to
+// a node: a fixed one, or with kLocalNode the node the allocating thread
+// is running on at the time of the call. Smaller requests stay on the heap
+// and get whatever node first touches them. When binding is unavailable
+// the mapping still succeeds (see PageAllocator::Stats::numaFallbacks).
+//
+// Unlike AlignedAllocator this one is stateful: containers only exchange
+// storage between allocators bound to the same node.
+template<typename T, std::size_t Alignment = 64, PageAllocator::HugePages Pages = PageAllocator::None>
+class NumaAllocator {
+public:
+    using value_type = T;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    template<class U>
+    struct rebind {
+        using other = NumaAllocator<U, Alignment, Pages>;
+    };
+
+    static constexpr int kLocalNode = -1;
+
+    static_assert((Alignment & (Alignment - 1)) == 0,
+                  "Alignment must be power of two");
+
+    static_assert(Alignment >= alignof(void*),
+                  "Alignment must be >= pointer alignment");
+
+    static_assert(Alignment <= (Pages == PageAllocator::None ? 4096 : PageAllocator::kHugePageSize),
+                  "Mappings are only page aligned");
+
+public:
+    constexpr explicit NumaAllocator(int node = kLocalNode) noexcept : _node(node) {}
+
+    template<class U>
+    constexpr NumaAllocator(const NumaAllocator<U, Alignment, Pages>& other) noexcept : _node(other.node()) {}
+
+    [[nodiscard]]
+    pointer allocate(size_type n)
+    {
+        if (n > std::numeric_limits<size_type>::max() / sizeof(T))
+            throw std::bad_alloc();
+
+        const size_type bytes = n * sizeof(T);
+        if (bytes >= mapThreshold()) {
+            const int node = (_node == kLocalNode) ? PageAllocator::currentNumaNode() : _node;
+            return static_cast<pointer>(detail::mapTagged(bytes, Pages, node));
+        }
+        return static_cast<pointer>(detail::heapAligned(bytes, Alignment));
+    }
+
+    void deallocate(pointer p, size_type n) noexcept
+    {
+        const size_type bytes = n * sizeof(T);
+        if (bytes >= mapThreshold()) {
+            detail::unmapTagged(p, bytes, Pages);
+            return;
+        }
+        detail::heapFree(p);
+    }
+
+    constexpr int node() const noexcept { return _node; }
+
+    template<class U>
+    constexpr bool operator==(const NumaAllocator<U, Alignment, Pages>& other) const noexcept { return _node == other.node(); }
+    template<class U>
+    constexpr bool operator!=(const NumaAllocator<U, Alignment, Pages>& other) const noexcept { return _node != other.node(); }
+
+private:
+    static size_type mapThreshold()
+    {
+        return Pages == PageAllocator::None ? PageAllocator::pageSize() : PageAllocator::kHugePageSize;
+    }
+
+    int _node;
+};
+
 } // namespace ink
 
 #endif
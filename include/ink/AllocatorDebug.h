@@ -0,0 +1,78 @@
+#ifndef ALLOCATORDEBUG_H
+#define ALLOCATORDEBUG_H
+
+// Diagnostics for InkedArena and ObjectPool, compiled in only when
+// INK_ALLOCATOR_DEBUG is set (the CMake option of the same name defines it
+// for the library and its consumers). With it off, none of this exists and
+// the allocators keep their production layout.
+#ifndef INK_ALLOCATOR_DEBUG
+#define INK_ALLOCATOR_DEBUG 0
+#endif
+
+// Counters kept on the allocation fast paths (InkedArena bytes requested,
+// ObjectPool live/peak live). On with INK_ALLOCATOR_DEBUG or the
+// INK_ALLOCATOR_STATS CMake option; production builds skip them.
+#ifndef INK_ALLOCATOR_STATS
+#define INK_ALLOCATOR_STATS INK_ALLOCATOR_DEBUG
+#endif
+
+#if INK_ALLOCATOR_DEBUG
+
+#include "ink/ink_base.hpp"
+#include "ink/Inkogger.h"
+
+namespace ink {
+
+/**
+ * @class AllocatorDebug
+ * @brief Poison/canary constants and the report sink for allocator
+ * diagnostics (double release, write after release, slot overruns, objects
+ * still live at pool destruction).
+ *
+ * Reports go to INK_ERROR unless a handler is installed, e.g. by tests
+ * that want to count them.
+ */
+class AllocatorDebug {
+public:
+    using Handler = void (*)(const char* what, const void* where);
+
+    static constexpr u8 kPoison = 0xDD;                    // freed bytes
+    static constexpr u64 kCanary = 0xC0FFEE0DDBADF00DULL; // slot trailer
+    static constexpr u64 kSlotLive = 0x4C4956454C495645ULL;
+    static constexpr u64 kSlotFree = 0x4652454546524545ULL;
+
+    static void setHandler(Handler handler) { slot() = handler; }
+
+    static void report(const char* what, const void* where)
+    {
+        if (Handler handler = slot())
+        {
+            handler(what, where);
+            return;
+        }
+        INK_ERROR << "[allocator] " << what << " at " << where;
+    }
+
+    static bool isPoisoned(const void* p, size_t len)
+    {
+        const u8* bytes = static_cast<const u8*>(p);
+        for (size_t i = 0; i < len; ++i)
+        {
+            if (bytes[i] != kPoison) return false;
+        }
+        return true;
+    }
+
+private:
+    static Handler& slot()
+    {
+        static Handler handler = nullptr;
+        return handler;
+    }
+};
+
+} // namespace ink
+
+#endif // INK_ALLOCATOR_DEBUG
+
+#endif // ALLOCATORDEBUG_H
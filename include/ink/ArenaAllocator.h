@@ -3,33 +3,122 @@
 
 #include <stddef.h>
 #include <string.h>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 #include "ink/ink_base.hpp"
+#include "ink/AllocatorDebug.h"
+#include "ink/PageAllocator.h"
 
 
 namespace ink {
 
 class InkedArena {
 public:
+    enum Flags : u32
+    {
+        Default = 0,
+        Prefault = 1 << 0,         // back pages up front (MAP_POPULATE) instead of on first touch
+        HugePages = 1 << 1,        // 2 MB aligned blocks advised for transparent huge pages
+        HugePagesExplicit = 1 << 2 // MAP_HUGETLB blocks, falling back to HugePages
+    };
+
     struct ArenaBlock {
         u8* memory;
-        size_t size;
+        size_t size;      // committed bytes usable from memory
         size_t offset;
         ArenaBlock* next;
+        size_t reserved;  // reserve mode: bytes reserved past memory, 0 otherwise
+        u32 granted;      // PageAllocator::Granted for the block's mapping
+    };
+
+    // Destructor record for objects built by arena_new/arena_new_array,
+    // itself allocated from the arena
+    struct ArenaFinalizer {
+        void (*destroy)(void* objects, size_t count);
+        void* objects;
+        size_t count;
+        ArenaFinalizer* next;
+    };
+
+    // Where an arena gets and returns its chained blocks. With acquire
+    // set, arena_alloc_hard asks it for every new block (a reset block of
+    // at least min_bytes, nullptr on failure) instead of mapping one, and
+    // arena_reset/arena_rewind/arena_destroy hand blocks back through
+    // release (a next-linked chain) instead of keeping spares or
+    // unmapping. BlockRecycler::source() is the usual one.
+    struct ArenaBlockSource {
+        ArenaBlock* (*acquire)(void* ctx, size_t min_bytes);
+        void (*release)(void* ctx, ArenaBlock* chain);
+        void* ctx;
     };
 
     struct Arena {
         ArenaBlock* head;
-        size_t block_size;
+        size_t block_size;    // reserve mode: commit granularity
+        ArenaBlock* spare;    // reset/rewound blocks waiting for reuse
+        size_t retain_bytes;  // arena_reset trims down to this (0 = keep all)
+        u32 flags;
+        ArenaFinalizer* finalizers; // newest first; run on reset/destroy/rewind
+        size_t requested;     // bytes asked of arena_alloc since the last reset (INK_ALLOCATOR_STATS)
+        size_t peak;          // high-water mark of used bytes, see arena_stats
+        ArenaBlockSource source; // acquire == nullptr: blocks are mapped directly
+    };
+
+    struct ArenaStats {
+        size_t requested;     // bytes asked for since the last reset; 0 without INK_ALLOCATOR_STATS
+        size_t used;          // bytes consumed in blocks; used - requested is alignment padding
+        size_t committed;     // usable capacity of in-use and spare blocks
+        size_t reserved;      // address space held, including uncommitted reserve
+        size_t blocks;        // blocks in use
+        size_t spare_blocks;
+        size_t peak;          // high-water mark of used, sampled at stats/reset/rewind
+    };
+
+    // Savepoint: the head block, its offset and the newest finalizer when
+    // the mark was taken
+    struct ArenaMark {
+        ArenaBlock* block;
+        size_t offset;
+        ArenaFinalizer* finalizers;
+        size_t requested;
     };
 
-    // Static helper to create blocks
-    static ArenaBlock* arena_new_block(size_t size);
+    // Static helpers to create and unmap blocks
+    static ArenaBlock* arena_new_block(size_t size, u32 flags = Default);
+    static void arena_free_block(ArenaBlock* b);
 
-    // Init/Destroy
-    void arena_init(Arena* a, size_t block_size);
-    void arena_reset(Arena* a);
-    void arena_destroy(Arena* a);
+    // Init/Destroy. arena_reset keeps the oldest block as head and parks
+    // the rest on the spare list, where arena_alloc_hard reuses them before
+    // mapping anything new.
+    static void arena_init(Arena* a, size_t block_size, u32 flags = Default);
+
+    // Reserve mode: reserves reserve_bytes of address space up front
+    // (MAP_NORESERVE / MEM_RESERVE) and commits it commit_step at a time as
+    // the bump pointer advances, so the arena grows in one contiguous
+    // region. Past the reservation it falls back to chaining blocks.
+    static void arena_init_reserve(Arena* a, size_t reserve_bytes, size_t commit_step, u32 flags = Default);
+    static void arena_reset(Arena* a);
+    static void arena_destroy(Arena* a);
+
+    // Returns spare blocks to the OS, then decommits the unused tail of a
+    // reserve-mode block, until the arena maps at most keep_bytes of block
+    // capacity (bytes below a block's offset are never released).
+    static void arena_trim(Arena* a, size_t keep_bytes);
+
+    // Savepoints. arena_rewind releases everything allocated after the
+    // mark (blocks added since then move to the spare list). Marks must be
+    // rewound in LIFO order and are invalidated by arena_reset.
+    static ArenaMark arena_mark(const Arena* a)
+    {
+        return ArenaMark{ a->head, a->head ? a->head->offset : 0, a->finalizers, a->requested };
+    }
+    static void arena_rewind(Arena* a, ArenaMark mark);
+
+    // Walks the block lists; also folds the current usage into the peak
+    static ArenaStats arena_stats(Arena* a);
 
     inline static void* arena_alloc_block(ArenaBlock* b, size_t size, size_t align)
     {
@@ -49,10 +138,13 @@ public:
     }
 
     // Main allocation function
-    inline void* arena_alloc(Arena* a, size_t size, size_t align)
+    inline static void* arena_alloc(Arena* a, size_t size, size_t align)
     {
         // Fast Path tring to alloc in current head
         ArenaBlock* b = a->head;
+#if INK_ALLOCATOR_STATS
+        a->requested += size;
+#endif
 
         if (b)
         {
@@ -63,8 +155,199 @@ public:
         return arena_alloc_hard(a, size, align);
     }
 
+    // Constructs a T in the arena. Non-trivially destructible types get a
+    // finalizer so their destructor runs (newest first) on arena_reset,
+    // arena_destroy, or a rewind past them. nullptr when the arena is out
+    // of memory; constructor exceptions propagate.
+    template<typename T, typename... Args>
+    static T* arena_new(Arena* a, Args&&... args)
+    {
+        ArenaFinalizer* fin = nullptr;
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            fin = static_cast<ArenaFinalizer*>(arena_alloc(a, sizeof(ArenaFinalizer), alignof(ArenaFinalizer)));
+            if (!fin) return nullptr;
+        }
+
+        void* mem = arena_alloc(a, sizeof(T), alignof(T));
+        if (!mem) return nullptr;
+
+        T* obj = ::new (mem) T(std::forward<Args>(args)...);
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            arena_push_finalizer(a, fin, obj, 1, &arena_destroy_objects<T>);
+        }
+        return obj;
+    }
+
+    // Value-initializes n Ts in the arena, with one finalizer for the whole
+    // array. If a constructor throws, the elements already built are
+    // destroyed before the exception propagates.
+    template<typename T>
+    static T* arena_new_array(Arena* a, size_t n)
+    {
+        if (n > static_cast<size_t>(-1) / sizeof(T)) return nullptr;
+
+        ArenaFinalizer* fin = nullptr;
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            fin = static_cast<ArenaFinalizer*>(arena_alloc(a, sizeof(ArenaFinalizer), alignof(ArenaFinalizer)));
+            if (!fin) return nullptr;
+        }
+
+        T* first = static_cast<T*>(arena_alloc(a, n * sizeof(T), alignof(T)));
+        if (!first) return nullptr;
+
+        size_t built = 0;
+        try
+        {
+            for (; built < n; ++built) ::new (static_cast<void*>(first + built)) T();
+        }
+        catch (...)
+        {
+            arena_destroy_objects<T>(first, built);
+            throw;
+        }
+
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            arena_push_finalizer(a, fin, first, n, &arena_destroy_objects<T>);
+        }
+        return first;
+    }
+
+    // Runs and unlinks finalizers, newest first, until stop is the newest
+    // (nullptr runs them all)
+    static void arena_run_finalizers(Arena* a, ArenaFinalizer* stop = nullptr);
+
+private:
+    template<typename T>
+    static void arena_destroy_objects(void* objects, size_t count)
+    {
+        T* first = static_cast<T*>(objects);
+        while (count) first[--count].~T();
+    }
+
+    static void arena_push_finalizer(Arena* a, ArenaFinalizer* fin, void* objects, size_t count,
+                                     void (*destroy)(void*, size_t))
+    {
+        fin->destroy = destroy;
+        fin->objects = objects;
+        fin->count = count;
+        fin->next = a->finalizers;
+        a->finalizers = fin;
+    }
+
+    static void* arena_alloc_hard(Arena* a, size_t size, size_t align);
+    static void arena_give_back(Arena* a, ArenaBlock* chain);
+    static bool arena_commit(Arena* a, ArenaBlock* b, size_t needed);
+};
+
+/**
+ * @class ArenaScope
+ * @brief RAII savepoint: rewinds the arena to where it was at construction,
+ * so nested scratch phases (parse, transform, emit) free their memory in
+ * LIFO order without resetting the whole arena.
+ */
+class ArenaScope {
+public:
+    explicit ArenaScope(InkedArena::Arena* a) noexcept : _arena(a), _mark(InkedArena::arena_mark(a)) {}
+
+    ~ArenaScope()
+    {
+        InkedArena::arena_rewind(_arena, _mark);
+    }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    InkedArena::Arena* _arena;
+    InkedArena::ArenaMark _mark;
+};
+
+/**
+ * @class ArenaResource
+ * @brief std::pmr::memory_resource over an InkedArena::Arena.
+ *
+ * Lets std::pmr containers (vector, string, unordered_map, ...) bump
+ * allocate from a per-request arena. Deallocation is a no-op: the memory
+ * comes back all at once with arena_reset/arena_destroy, so containers
+ * using it must be gone (or never touched again) by then.
+ *
+ * The resource does not own the arena.
+ */
+class ArenaResource : public std::pmr::memory_resource {
+public:
+    explicit ArenaResource(InkedArena::Arena* a) noexcept : _arena(a) {}
+
+    InkedArena::Arena* arena() const noexcept { return _arena; }
+
+private:
+    void* do_allocate(size_t bytes, size_t align) override
+    {
+        void* mem = InkedArena::arena_alloc(_arena, bytes, align);
+        if (!mem) throw std::bad_alloc();
+        return mem;
+    }
+
+    void do_deallocate(void*, size_t, size_t) override
+    {
+        // Reclaimed by arena_reset/arena_destroy
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        const ArenaResource* rhs = dynamic_cast<const ArenaResource*>(&other);
+        return rhs && rhs->_arena == _arena;
+    }
+
+    InkedArena::Arena* _arena;
+};
+
+/**
+ * @class ArenaAllocator
+ * @brief std-compatible typed allocator drawing from an InkedArena::Arena,
+ * for containers that take an allocator template argument instead of a
+ * memory_resource. Same lifetime rules as ArenaResource.
+ */
+template<typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    // Allocators comparing equal must be able to free each other's memory;
+    // two allocators are equal when they share an arena.
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    explicit ArenaAllocator(InkedArena::Arena* a) noexcept : _arena(a) {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : _arena(other.arena()) {}
+
+    [[nodiscard]]
+    T* allocate(size_t n)
+    {
+        if (n > static_cast<size_t>(-1) / sizeof(T)) throw std::bad_alloc();
+        void* mem = InkedArena::arena_alloc(_arena, n * sizeof(T), alignof(T));
+        if (!mem) throw std::bad_alloc();
+        return static_cast<T*>(mem);
+    }
+
+    void deallocate(T*, size_t) noexcept
+    {
+        // Reclaimed by arena_reset/arena_destroy
+    }
+
+    InkedArena::Arena* arena() const noexcept { return _arena; }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept { return _arena == other.arena(); }
+
 private:
-    void* arena_alloc_hard(Arena* a, size_t size, size_t align);
+    InkedArena::Arena* _arena;
 };
 
 }
@@ -0,0 +1,253 @@
+#ifndef BROADCASTRING_H
+#define BROADCASTRING_H
+
+#include <atomic>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "ink/ink_base.hpp"
+#include "ink/CachePadded.h"
+
+namespace ink {
+
+/*====================
+ * WAIT STRATEGIES
+ *====================*/
+// A strategy provides waitUntil(ready) and signalAll(); signalAll() runs
+// after every publish/commit/close, so cheap strategies make it a no-op.
+
+// Lowest latency, burns a core per waiting thread
+struct BusySpinWaitStrategy {
+    template<typename Ready>
+    void waitUntil(Ready&& ready) {
+        while (!ready()) detail::cpuRelax();
+    }
+    void signalAll() noexcept {}
+};
+
+// Spins briefly, then yields the CPU between checks
+struct YieldingWaitStrategy {
+    template<typename Ready>
+    void waitUntil(Ready&& ready) {
+        for (u32 spins = 0; !ready(); ++spins) {
+            if (spins < 128) detail::cpuRelax();
+            else std::this_thread::yield();
+        }
+    }
+    void signalAll() noexcept {}
+};
+
+// Parks waiters in std::atomic::wait; every signal bumps a shared epoch
+struct BlockingWaitStrategy {
+    std::atomic<u32> epoch{0};
+
+    template<typename Ready>
+    void waitUntil(Ready&& ready) {
+        while (!ready()) {
+            const u32 seen = epoch.load(std::memory_order_acquire);
+            if (ready()) return;
+            epoch.wait(seen, std::memory_order_acquire);
+        }
+    }
+    void signalAll() noexcept {
+        epoch.fetch_add(1, std::memory_order_acq_rel);
+        epoch.notify_all();
+    }
+};
+
+/**
+ * @class BroadcastRing
+ * @brief Single-writer, multi-reader broadcast ring in the style of the
+ * LMAX disruptor.
+ *
+ * Every reader sees every event. Slots are preallocated T objects that the
+ * writer overwrites in place, readers track their own sequence cursor, and
+ * the writer is gated by the slowest reader so no slot is reused before all
+ * readers have committed past it.
+ *
+ * Writer:  claim(n) -> fill ring[seq..seq+n) -> publish(seq, n)
+ * Reader:  reader(i).poll(fn) / consume(fn), or waitFor() + commit()
+ *
+ * @tparam T Event type (default constructible; slots are reused).
+ * @tparam WaitStrategy BusySpinWaitStrategy, YieldingWaitStrategy or
+ *         BlockingWaitStrategy.
+ */
+template<typename T, typename WaitStrategy = YieldingWaitStrategy>
+class BroadcastRing
+{
+private:
+    struct alignas(kCacheLineSize) Cursor {
+        std::atomic<u64> next{0}; // first sequence not yet consumed
+    };
+
+public:
+    class Reader {
+    public:
+        // Highest published sequence + 1 visible right now
+        u64 available() const { return _ring->_cursor.load(std::memory_order_acquire); }
+        u64 next() const { return _cursor->next.load(std::memory_order_relaxed); }
+
+        // Blocks until an event past next() is published, or the ring is
+        // closed; returns the exclusive end of the readable batch.
+        u64 waitFor() {
+            const u64 from = next();
+            _ring->_wait.waitUntil([&] { return available() > from || _ring->closed(); });
+            return available();
+        }
+
+        // Releases every slot below upTo back to the writer
+        void commit(u64 upTo) {
+            _cursor->next.store(upTo, std::memory_order_release);
+            _ring->_wait.signalAll();
+        }
+
+        const T& operator[](u64 seq) const { return _ring->slot(seq); }
+
+        // Hands every readable event to fn(const T&, u64 seq, bool endOfBatch)
+        // and commits the batch. Never blocks.
+        template<typename Fn>
+        size_t poll(Fn&& fn) {
+            return drain(available(), fn);
+        }
+
+        // Like poll(), but blocks for at least one event; returns 0 only
+        // once the ring is closed and this reader has drained it.
+        template<typename Fn>
+        size_t consume(Fn&& fn) {
+            return drain(waitFor(), fn);
+        }
+
+    private:
+        friend class BroadcastRing;
+
+        template<typename Fn>
+        size_t drain(u64 end, Fn& fn) {
+            const u64 from = next();
+            for (u64 seq = from; seq < end; ++seq) {
+                fn(_ring->slot(seq), seq, seq + 1 == end);
+            }
+            if (end > from) commit(end);
+            return static_cast<size_t>(end - from);
+        }
+
+        BroadcastRing* _ring = nullptr;
+        Cursor* _cursor = nullptr;
+    };
+
+    // Capacity is rounded up to a power of two; reader count is fixed
+    BroadcastRing(size_t capacity, size_t readerCount) :
+        _capacity(detail::roundPow2(INK_MAX(capacity, size_t(1)))),
+        _mask(_capacity - 1),
+        _slots(_capacity),
+        _cursors(readerCount),
+        _readers(readerCount),
+        _claimed(0),
+        _cachedMinReader(0),
+        _cursor(0),
+        _closed(false)
+    {
+        for (size_t i = 0; i < readerCount; ++i) {
+            _readers[i]._ring = this;
+            _readers[i]._cursor = &_cursors[i];
+        }
+    }
+
+    BroadcastRing(const BroadcastRing&) = delete;
+    BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+    Reader& reader(size_t i) { return _readers[i]; }
+    size_t readerCount() const { return _readers.size(); }
+    size_t capacity() const { return _capacity; }
+
+    // Writer: reserves n (<= capacity) consecutive sequences, waiting for
+    // the slowest reader to free them. Returns the first sequence. Throws
+    // std::length_error for n > capacity(), which could never be satisfied.
+    u64 claim(size_t n = 1) {
+        if (INK_UNLIKELY(n > _capacity)) throw std::length_error("BroadcastRing::claim: n exceeds capacity");
+        const u64 first = _claimed;
+        const u64 wrapPoint = first + n - _capacity;
+        if (first + n > _capacity && _cachedMinReader < wrapPoint) {
+            _wait.waitUntil([&] { return (_cachedMinReader = minReader()) >= wrapPoint; });
+        }
+        _claimed = first + n;
+        return first;
+    }
+
+    // Writer: like claim() but fails instead of waiting (and for
+    // n > capacity(), which would never succeed)
+    std::optional<u64> tryClaim(size_t n = 1) {
+        if (INK_UNLIKELY(n > _capacity)) return std::nullopt;
+        const u64 first = _claimed;
+        if (first + n > _capacity) {
+            const u64 wrapPoint = first + n - _capacity;
+            if (_cachedMinReader < wrapPoint && (_cachedMinReader = minReader()) < wrapPoint) {
+                return std::nullopt;
+            }
+        }
+        _claimed = first + n;
+        return first;
+    }
+
+    // Writer: slot for a claimed sequence
+    T& operator[](u64 seq) { return slot(seq); }
+
+    // Writer: makes [first, first + n) visible to every reader. Batches
+    // must be published in claim order.
+    void publish(u64 first, size_t n = 1) {
+        _cursor.store(first + n, std::memory_order_release);
+        _wait.signalAll();
+    }
+
+    // Writer convenience: claim + assign + publish a single event
+    template<typename U>
+    void push(U&& value) {
+        const u64 seq = claim(1);
+        slot(seq) = std::forward<U>(value);
+        publish(seq, 1);
+    }
+
+    // Wakes every waiting reader; consume() returns 0 once drained
+    void close() {
+        _closed.store(true, std::memory_order_release);
+        _wait.signalAll();
+    }
+
+    bool closed() const { return _closed.load(std::memory_order_acquire); }
+
+    // Published sequence count
+    u64 cursor() const { return _cursor.load(std::memory_order_acquire); }
+
+private:
+    T& slot(u64 seq) { return _slots[static_cast<size_t>(seq & _mask)]; }
+
+    u64 minReader() const {
+        u64 lowest = _claimed;
+        for (const Cursor& c : _cursors) {
+            const u64 seq = c.next.load(std::memory_order_acquire);
+            if (seq < lowest) lowest = seq;
+        }
+        return lowest;
+    }
+
+    const size_t _capacity;
+    const size_t _mask;
+    std::vector<T> _slots;
+    std::vector<Cursor> _cursors;
+    std::vector<Reader> _readers;
+
+    // Writer-only state
+    alignas(kCacheLineSize) u64 _claimed;
+    u64 _cachedMinReader;
+
+    // Published cursor, read by every reader
+    alignas(kCacheLineSize) std::atomic<u64> _cursor;
+    std::atomic<bool> _closed;
+
+    alignas(kCacheLineSize) WaitStrategy _wait;
+};
+
+} // namespace ink
+
+#endif // BROADCASTRING_H
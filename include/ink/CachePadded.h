@@ -0,0 +1,217 @@
+#ifndef CACHEPADDED_H
+#define CACHEPADDED_H
+
+#include <atomic>
+#include <bit>
+#include <limits>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+
+#include "ink/ink_base.hpp"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+#if defined(INK_PLATFORM_WINDOWS)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace ink {
+
+// Distance that keeps two independently written objects off the same cache
+// line. GCC warns that its std::hardware_destructive_interference_size may
+// change between compiler versions (an ABI hazard in a header), so it only
+// takes the standard value from other compilers; 64 otherwise, 128 where
+// lines (or adjacent-line prefetch pairs) are 128 bytes.
+#if defined(__cpp_lib_hardware_interference_size) && !defined(__GNUC__)
+inline constexpr size_t kCacheLineSize = std::hardware_destructive_interference_size;
+#elif (defined(__aarch64__) && defined(__APPLE__)) || defined(__powerpc64__)
+inline constexpr size_t kCacheLineSize = 128;
+#else
+inline constexpr size_t kCacheLineSize = 64;
+#endif
+
+namespace detail {
+
+// Spin-loop hint: lets the sibling hyperthread run and saves power
+INK_FORCEINLINE void cpuRelax() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__) && !defined(INK_COMPILER_MSVC)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// Small dense id per thread, assigned on first use; used to pick shards
+inline u32 threadIndex() noexcept
+{
+    static std::atomic<u32> next{0};
+    thread_local const u32 index = next.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+// CPU the calling thread is running on right now (it may migrate at any
+// moment, so only use it as a hint); the thread index where unknown
+inline u32 currentCpu() noexcept
+{
+#if defined(INK_PLATFORM_WINDOWS)
+    return static_cast<u32>(GetCurrentProcessorNumber());
+#elif defined(__linux__)
+    const int cpu = sched_getcpu();
+    return cpu >= 0 ? static_cast<u32>(cpu) : threadIndex();
+#else
+    return threadIndex();
+#endif
+}
+
+// Smallest power of two >= n (1 for 0). Shared by every ring and shard
+// table that indexes with a mask; throws std::bad_alloc when n is above
+// the largest power of two a size_t holds, since no such table fits anyway.
+inline size_t roundPow2(size_t n)
+{
+    if (INK_UNLIKELY(n > (std::numeric_limits<size_t>::max() >> 1) + 1)) throw std::bad_alloc();
+    return std::bit_ceil(n);
+}
+
+}
+
+/**
+ * @struct CachePadded
+ * @brief Wraps a T so it owns whole cache lines: aligned to kCacheLineSize
+ * and padded out to a multiple of it. Use it for a field written by one
+ * thread next to fields another thread writes or polls.
+ */
+template<typename T>
+struct alignas(kCacheLineSize) CachePadded
+{
+    T value;
+
+    CachePadded() : value()
+    {
+        // Empty
+    }
+
+    template<typename... Args>
+    explicit CachePadded(std::in_place_t, Args&&... args) : value(std::forward<Args>(args)...)
+    {
+        // Empty
+    }
+
+    T& operator*() noexcept { return value; }
+    const T& operator*() const noexcept { return value; }
+    T* operator->() noexcept { return &value; }
+    const T* operator->() const noexcept { return &value; }
+};
+
+/**
+ * @class PerThread
+ * @brief A power-of-two array of cache-padded T shards, one picked per
+ * thread by its dense thread index.
+ *
+ * With at least as many shards as threads, each thread gets a private
+ * line; beyond that threads share shards, so T must tolerate concurrent
+ * use (typically an atomic updated with relaxed ordering).
+ */
+template<typename T>
+class PerThread
+{
+public:
+    // shards: rounded up to a power of two; defaults to twice the cores
+    explicit PerThread(size_t shards = 0) :
+        _count(detail::roundPow2(shards ? shards : INK_MAX(2 * std::thread::hardware_concurrency(), 4u))),
+        _shards(new CachePadded<T>[_count])
+    {
+        // Empty
+    }
+
+    T& local() noexcept { return _shards[detail::threadIndex() & (_count - 1)].value; }
+
+    template<typename F>
+    void forEach(F&& f) const {
+        for (size_t i = 0; i < _count; ++i) f(_shards[i].value);
+    }
+
+    size_t shardCount() const noexcept { return _count; }
+
+private:
+    const size_t _count;
+    std::unique_ptr<CachePadded<T>[]> _shards;
+};
+
+/**
+ * @class PerCpu
+ * @brief Like PerThread, but picks the shard of the CPU the caller is
+ * running on, so many short-lived threads still spread over few lines.
+ * Threads migrate, so two of them can meet on a shard: T must tolerate
+ * concurrent use.
+ */
+template<typename T>
+class PerCpu
+{
+public:
+    // shards: rounded up to a power of two; defaults to the core count
+    explicit PerCpu(size_t shards = 0) :
+        _count(detail::roundPow2(shards ? shards : INK_MAX(std::thread::hardware_concurrency(), 1u))),
+        _shards(new CachePadded<T>[_count])
+    {
+        // Empty
+    }
+
+    T& local() noexcept { return _shards[detail::currentCpu() & (_count - 1)].value; }
+
+    template<typename F>
+    void forEach(F&& f) const {
+        for (size_t i = 0; i < _count; ++i) f(_shards[i].value);
+    }
+
+    size_t shardCount() const noexcept { return _count; }
+
+private:
+    const size_t _count;
+    std::unique_ptr<CachePadded<T>[]> _shards;
+};
+
+/**
+ * @class ShardedCounter
+ * @brief Statistics counter that many threads bump without fighting over
+ * one cache line: add() is a relaxed fetch_add on the caller's shard, and
+ * load() sums the shards (a snapshot, not a linearizable read).
+ *
+ * @tparam Shards PerThread<std::atomic<u64>> or PerCpu<std::atomic<u64>>.
+ */
+template<typename Shards = PerThread<std::atomic<u64>>>
+class ShardedCounter
+{
+public:
+    explicit ShardedCounter(size_t shards = 0) : _shards(shards)
+    {
+        // Empty
+    }
+
+    void add(u64 n = 1) noexcept { _shards.local().fetch_add(n, std::memory_order_relaxed); }
+
+    u64 load() const noexcept {
+        u64 sum = 0;
+        _shards.forEach([&sum](const std::atomic<u64>& shard) { sum += shard.load(std::memory_order_relaxed); });
+        return sum;
+    }
+
+private:
+    Shards _shards;
+};
+
+} // namespace ink
+
+#endif // CACHEPADDED_H
@@ -0,0 +1,132 @@
+#ifndef CONCURRENTARENA_H
+#define CONCURRENTARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
+#include "ink/ink_base.hpp"
+#include "ink/ArenaAllocator.h"
+#include "ink/CachePadded.h"
+
+namespace ink {
+
+/**
+ * @class BlockRecycler
+ * @brief Mutex-protected pool of InkedArena blocks shared between threads.
+ *
+ * Thread arenas and ConcurrentArena hand their blocks back here on reset
+ * instead of unmapping them, and pull from it before mapping new ones, so
+ * a steady-state workload stops touching mmap altogether. The lock is only
+ * taken on block refill/return, never per allocation.
+ */
+class INK_API BlockRecycler {
+public:
+    explicit BlockRecycler(size_t blockSize = 64 * 1024, u32 flags = InkedArena::Default);
+    ~BlockRecycler();
+
+    BlockRecycler(const BlockRecycler&) = delete;
+    BlockRecycler& operator=(const BlockRecycler&) = delete;
+
+    // A reset block with at least minBytes usable: pooled when one fits,
+    // freshly mapped (max(minBytes, blockSize)) otherwise. nullptr only
+    // when mapping fails.
+    InkedArena::ArenaBlock* acquire(size_t minBytes);
+
+    // Takes back a whole next-linked chain of blocks
+    void release(InkedArena::ArenaBlock* chain);
+
+    // Unmaps pooled blocks until at most keepBytes stay pooled
+    void trim(size_t keepBytes);
+
+    size_t pooledBytes() const;
+    size_t blockSize() const { return _blockSize; }
+
+    // Block source that feeds an InkedArena::Arena from this recycler:
+    // every block the arena chains on comes from acquire(), and reset,
+    // rewind and destroy hand blocks back through release()
+    InkedArena::ArenaBlockSource source() { return InkedArena::ArenaBlockSource{ &acquireThunk, &releaseThunk, this }; }
+
+    // Process-wide recycler behind ThreadArena
+    static BlockRecycler& global();
+
+private:
+    static InkedArena::ArenaBlock* acquireThunk(void* self, size_t minBytes);
+    static void releaseThunk(void* self, InkedArena::ArenaBlock* chain);
+
+    mutable std::mutex _mutex;
+    InkedArena::ArenaBlock* _free;
+    size_t _pooledBytes;
+    const size_t _blockSize;
+    const u32 _flags;
+};
+
+/**
+ * @class ThreadArena
+ * @brief Per-thread InkedArena reached through a thread_local handle.
+ *
+ * Each thread lazily gets its own Arena whose block source is
+ * BlockRecycler::global(), so allocation is the usual uncontended bump and
+ * workers no longer manage Arena structs by hand. Every path that needs a
+ * block (alloc(), arena_alloc or ArenaResource on local()) pulls it from
+ * the recycler, and reset(), savepoint rewinds and thread exit return
+ * blocks to it for other threads to reuse.
+ *
+ * @note Memory from a thread's arena may be read by other threads, but it
+ * is only valid until the owning thread calls reset() or exits.
+ */
+class INK_API ThreadArena {
+public:
+    // Calling thread's arena; usable with arena_mark/ArenaScope/ArenaResource
+    static InkedArena::Arena* local();
+
+    static void* alloc(size_t size, size_t align = alignof(std::max_align_t))
+    {
+        return InkedArena::arena_alloc(local(), size, align);
+    }
+
+    // Frees everything this thread allocated, keeping one block and handing
+    // the rest to the recycler
+    static void reset();
+};
+
+/**
+ * @class ConcurrentArena
+ * @brief Arena that many threads can bump-allocate from at once.
+ *
+ * The head block's offset is advanced with a compare-and-swap, so threads
+ * appending into one shared arena (e.g. parallel parse output) never take
+ * a lock on the fast path; only the thread that finds the head full takes
+ * the mutex to chain on a block from the recycler. Blocks are never
+ * unmapped while the arena is live, so a pointer from alloc() stays valid
+ * until reset().
+ *
+ * @note reset() must not run concurrently with alloc().
+ */
+class INK_API ConcurrentArena {
+public:
+    explicit ConcurrentArena(size_t blockSize = 1 << 20, u32 flags = InkedArena::Default);
+    ~ConcurrentArena();
+
+    ConcurrentArena(const ConcurrentArena&) = delete;
+    ConcurrentArena& operator=(const ConcurrentArena&) = delete;
+
+    // Thread-safe; nullptr only when mapping a new block fails
+    void* alloc(size_t size, size_t align = alignof(std::max_align_t));
+
+    // Keeps the oldest block, recycles the rest
+    void reset();
+
+    size_t blockCount() const;
+
+private:
+    void* grow(InkedArena::ArenaBlock* seen, size_t size, size_t align);
+
+    BlockRecycler _recycler;
+    mutable std::mutex _growMutex;
+    alignas(kCacheLineSize) std::atomic<InkedArena::ArenaBlock*> _head;
+};
+
+} // namespace ink
+
+#endif // CONCURRENTARENA_H
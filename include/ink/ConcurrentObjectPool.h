@@ -0,0 +1,320 @@
+#ifndef CONCURRENTOBJECTPOOL_H
+#define CONCURRENTOBJECTPOOL_H
+
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ink/ink_base.hpp"
+#include "ink/CachePadded.h"
+#include "ink/PoolPtr.h"
+
+namespace ink {
+
+/**
+ * @class ConcurrentObjectPool
+ * @brief Thread-safe object pool with per-thread magazine caches, in the
+ * style of the Bonwick/Adams magazine allocator.
+ *
+ * Each thread maps to a cache shard (by a dense thread index) holding a
+ * loaded and a previous magazine of free slots, so acquire/release are a
+ * pointer pop/push under an uncontended shard spinlock. When both
+ * magazines are empty (or full), the shard swaps a whole magazine with a
+ * lock-free global depot of full and empty magazines; only when the depot
+ * has no full magazine does a thread take the slab mutex to carve new
+ * slots. Releasing on a different thread than the one that acquired is
+ * fine: the slot simply joins the releasing thread's magazine and flows
+ * back through the depot.
+ *
+ * release() never fails: if it needs an empty magazine and none can be
+ * allocated, the slot goes onto a spill list under the slab mutex, which
+ * the next refill drains before carving fresh slots. Magazines are
+ * allocated in chunks that double in size, so the chunk table stays a few
+ * hundred bytes and the magazine count is bounded only by the 32-bit
+ * depot index.
+ *
+ * @note As with ObjectPool, every object must be released before the pool
+ * is destroyed.
+ *
+ * @tparam T The type of object to be stored in the pool.
+ * @tparam MagazineSize Slots per magazine (the batch moved per depot trip).
+ */
+template<typename T, usize MagazineSize = 64>
+class ConcurrentObjectPool
+{
+    static_assert(MagazineSize > 0, "MagazineSize must be positive");
+
+public:
+    // slabSlots: slots carved per slab refill (at least one magazine).
+    // shards: cache shards, rounded up to a power of two; the default of
+    // twice the core count keeps threads from sharing one in practice.
+    explicit ConcurrentObjectPool(size_t slabSlots = 4096, size_t shards = 0) :
+        _slabSlots(INK_MAX(slabSlots, MagazineSize)),
+        _shardCount(detail::roundPow2(shards ? shards : INK_MAX(2 * std::thread::hardware_concurrency(), 4u))),
+        _shards(new Shard[_shardCount]),
+        _magazineCount(0),
+        _spilled(nullptr),
+        _bumpNext(nullptr),
+        _bumpEnd(nullptr)
+    {
+        for (auto& chunk : _chunks) chunk.store(nullptr, std::memory_order_relaxed);
+    }
+
+    ConcurrentObjectPool(const ConcurrentObjectPool&) = delete;
+    ConcurrentObjectPool& operator=(const ConcurrentObjectPool&) = delete;
+
+    ~ConcurrentObjectPool() {
+        for (auto& chunk : _chunks) {
+            delete[] chunk.load(std::memory_order_relaxed);
+        }
+        for (void* slab : _slabs) {
+            ::operator delete[](slab, std::align_val_t(alignof(Slot)));
+        }
+    }
+
+    // Acquires a free slot and constructs a T in place. Thread-safe.
+    template<typename... Args>
+    [[nodiscard]] T* acquire(Args&&... args) {
+        Shard& shard = localShard();
+        void* mem;
+        {
+            SpinGuard guard(shard.lock);
+            mem = shard.pop(*this);
+        }
+        return ::new (mem) T(std::forward<Args>(args)...);
+    }
+
+    // Destroys obj and caches its slot. Any thread may release any object;
+    // never allocates in a way that can fail.
+    void release(T* obj) noexcept {
+        obj->~T();
+        Shard& shard = localShard();
+        SpinGuard guard(shard.lock);
+        shard.push(*this, obj);
+    }
+
+    // acquire() wrapped in a handle that releases the object when dropped
+    template<typename... Args>
+    [[nodiscard]] PoolPtr<T> make(Args&&... args) {
+        return PoolPtr<T>(acquire(std::forward<Args>(args)...), this, &releaseThunk);
+    }
+
+    size_t capacity() const {
+        std::lock_guard<std::mutex> lock(_slabMutex);
+        return _slabs.size() * _slabSlots;
+    }
+
+    size_t shardCount() const { return _shardCount; }
+
+private:
+    // A spilled slot holds the spill-list link in its own storage
+    union Slot {
+        Slot* next;
+        alignas(T) u8 storage[sizeof(T)];
+    };
+
+    static constexpr u32 kNone = 0xFFFFFFFFu;
+    // Chunk c holds kChunkMagazines << c magazines, so 27 chunks cover
+    // every index below kNone
+    static constexpr size_t kChunkMagazines = 64;
+    static constexpr size_t kMaxChunks = 27;
+
+    struct Magazine {
+        void* slots[MagazineSize];
+        u32 count = 0;
+        u32 index = 0;
+        std::atomic<u32> next{kNone}; // depot link
+    };
+
+    // Treiber stack of magazine indices. The head packs a 32-bit ABA tag
+    // above the index, so a pop racing with pop+push of the same magazine
+    // fails its CAS instead of corrupting the list.
+    class Depot {
+    public:
+        void push(Magazine* mag) {
+            u64 head = _head.load(std::memory_order_relaxed);
+            u64 next;
+            do {
+                mag->next.store(static_cast<u32>(head), std::memory_order_relaxed);
+                next = ((head >> 32) + 1) << 32 | mag->index;
+            } while (!_head.compare_exchange_weak(head, next, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        Magazine* pop(ConcurrentObjectPool& pool) {
+            u64 head = _head.load(std::memory_order_acquire);
+            while (static_cast<u32>(head) != kNone) {
+                Magazine* mag = pool.magazine(static_cast<u32>(head));
+                const u64 next = ((head >> 32) + 1) << 32 | mag->next.load(std::memory_order_relaxed);
+                if (_head.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire))
+                    return mag;
+            }
+            return nullptr;
+        }
+
+    private:
+        alignas(kCacheLineSize) std::atomic<u64> _head{kNone};
+    };
+
+    // Test-and-test-and-set lock; a shard is normally touched by one thread.
+    // Yields after a short spin in case the holder was preempted.
+    struct SpinLock {
+        std::atomic<bool> locked{false};
+
+        void lock() noexcept {
+            for (u32 spins = 0;; ) {
+                if (!locked.exchange(true, std::memory_order_acquire)) return;
+                while (locked.load(std::memory_order_relaxed)) {
+                    if (++spins < 64) detail::cpuRelax();
+                    else std::this_thread::yield();
+                }
+            }
+        }
+        void unlock() noexcept { locked.store(false, std::memory_order_release); }
+    };
+
+    struct SpinGuard {
+        explicit SpinGuard(SpinLock& l) : lock(l) { lock.lock(); }
+        ~SpinGuard() { lock.unlock(); }
+        SpinLock& lock;
+    };
+
+    struct alignas(kCacheLineSize) Shard {
+        SpinLock lock;
+        Magazine* loaded = nullptr;
+        Magazine* previous = nullptr;
+
+        void* pop(ConcurrentObjectPool& pool) {
+            if (loaded && loaded->count) return loaded->slots[--loaded->count];
+            if (previous && previous->count) {
+                std::swap(loaded, previous);
+                return loaded->slots[--loaded->count];
+            }
+            // Both empty: trade the spare empty for a full one
+            Magazine* full = pool._full.pop(pool);
+            if (!full) full = pool.refill();
+            if (previous) pool._empty.push(previous);
+            previous = loaded;
+            loaded = full;
+            return loaded->slots[--loaded->count];
+        }
+
+        void push(ConcurrentObjectPool& pool, void* slot) {
+            if (loaded && loaded->count < MagazineSize) {
+                loaded->slots[loaded->count++] = slot;
+                return;
+            }
+            if (previous && previous->count < MagazineSize) {
+                std::swap(loaded, previous);
+                loaded->slots[loaded->count++] = slot;
+                return;
+            }
+            // Both full (or missing): retire one full, take an empty
+            Magazine* empty = pool._empty.pop(pool);
+            if (!empty) empty = pool.newMagazine();
+            if (!empty) {
+                pool.spill(slot);
+                return;
+            }
+            if (previous) pool._full.push(previous);
+            previous = loaded;
+            loaded = empty;
+            loaded->slots[loaded->count++] = slot;
+        }
+    };
+
+    static void releaseThunk(void* pool, T* obj) {
+        static_cast<ConcurrentObjectPool*>(pool)->release(obj);
+    }
+
+    Shard& localShard() {
+        return _shards[detail::threadIndex() & (_shardCount - 1)];
+    }
+
+    // Chunk holding magazine index, and the first index in that chunk
+    static size_t chunkOf(u32 index) {
+        return static_cast<size_t>(std::bit_width(index / kChunkMagazines + 1) - 1);
+    }
+
+    static size_t chunkBase(size_t chunk) {
+        return kChunkMagazines * ((size_t(1) << chunk) - 1);
+    }
+
+    Magazine* magazine(u32 index) {
+        const size_t chunk = chunkOf(index);
+        return &_chunks[chunk].load(std::memory_order_acquire)[index - chunkBase(chunk)];
+    }
+
+    // Magazines live in chunks that are never freed before the pool, so a
+    // depot index always names valid memory. nullptr when out of memory.
+    Magazine* newMagazine() noexcept {
+        std::lock_guard<std::mutex> lock(_magazineMutex);
+        const u32 index = _magazineCount;
+        if (index == kNone) return nullptr;
+        const size_t chunk = chunkOf(index);
+        if (index == chunkBase(chunk)) {
+            const size_t count = kChunkMagazines << chunk;
+            Magazine* fresh = new (std::nothrow) Magazine[count];
+            if (!fresh) return nullptr;
+            for (size_t i = 0; i < count; ++i) fresh[i].index = static_cast<u32>(index + i);
+            _chunks[chunk].store(fresh, std::memory_order_release);
+        }
+        ++_magazineCount;
+        return magazine(index);
+    }
+
+    // Release fallback when no empty magazine can be had
+    void spill(void* storage) noexcept {
+        Slot* slot = reinterpret_cast<Slot*>(storage);
+        std::lock_guard<std::mutex> lock(_slabMutex);
+        slot->next = _spilled;
+        _spilled = slot;
+    }
+
+    // Fills a magazine from spilled slots, then straight from the slabs
+    Magazine* refill() {
+        Magazine* mag = _empty.pop(*this);
+        if (!mag) mag = newMagazine();
+        if (!mag) throw std::bad_alloc();
+        std::lock_guard<std::mutex> lock(_slabMutex);
+        while (mag->count < MagazineSize && _spilled) {
+            mag->slots[mag->count++] = _spilled->storage;
+            _spilled = _spilled->next;
+        }
+        while (mag->count < MagazineSize) {
+            if (_bumpNext == _bumpEnd) {
+                Slot* slab = static_cast<Slot*>(::operator new[](_slabSlots * sizeof(Slot), std::align_val_t(alignof(Slot))));
+                _slabs.push_back(slab);
+                _bumpNext = slab;
+                _bumpEnd = slab + _slabSlots;
+            }
+            mag->slots[mag->count++] = (_bumpNext++)->storage;
+        }
+        return mag;
+    }
+
+    const size_t _slabSlots;
+    const size_t _shardCount;
+    std::unique_ptr<Shard[]> _shards;
+
+    Depot _full;
+    Depot _empty;
+
+    std::mutex _magazineMutex;
+    u32 _magazineCount;
+    std::atomic<Magazine*> _chunks[kMaxChunks];
+
+    mutable std::mutex _slabMutex;
+    std::vector<void*> _slabs;
+    Slot* _spilled;
+    Slot* _bumpNext;
+    Slot* _bumpEnd;
+};
+
+} // namespace ink
+
+#endif // CONCURRENTOBJECTPOOL_H
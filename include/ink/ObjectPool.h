@@ -1,38 +1,134 @@
 #ifndef OBJECTPOOL_H
 #define OBJECTPOOL_H
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
 #include <new>
 #include <utility>
 #include <vector>
 
 #include "ink_base.hpp"
+#include "AllocatorDebug.h"
+#include "PageAllocator.h"
+#include "PoolPtr.h"
+
+#if !defined(INK_PLATFORM_WINDOWS)
+#include <sys/uio.h>
+#endif
 
 namespace ink {
 
+/**
+ * @struct SlabRegion
+ * @brief One pool slab as a base/length pair. Laid out like struct iovec,
+ * so a std::vector<SlabRegion> can be passed straight to
+ * io_uring_register_buffers() (or readv/writev) via reinterpret_cast.
+ */
+struct SlabRegion {
+    void* iov_base;
+    size_t iov_len;
+};
+
+#if !defined(INK_PLATFORM_WINDOWS)
+static_assert(sizeof(SlabRegion) == sizeof(iovec) &&
+              offsetof(SlabRegion, iov_base) == offsetof(iovec, iov_base) &&
+              offsetof(SlabRegion, iov_len) == offsetof(iovec, iov_len),
+              "SlabRegion must stay layout-compatible with iovec");
+#endif
+
 /**
  * @class ObjectPool
  * @brief A high-performance, contiguous memory pool for object recycling.
  * This pool uses placement new and pre-allocated memory slabs to provide O(1)
  * allocation and deallocation.
  *
- * @note Works well with io_uring by providing memory-aligned blocks
- * that can be registered as "Fixed Buffers" with the kernel.
+ * @note Works well with io_uring: slabs never move while the pool lives,
+ * and slabRegions() exports all of them as an iovec list whose positions
+ * are stable slab indices, ready for io_uring_register_buffers(). Slabs
+ * come from the heap by default; those added while an onSlabAdded()
+ * listener is installed are mapped through PageAllocator instead, so they
+ * are page aligned and whole pages long. The constructor allocates the
+ * first slab before any listener exists, so for that one to be page
+ * aligned too set Config::exportSlabs (or use huge pages), which maps
+ * every slab. onSlabAdded() reports each new slab as the
+ * pool grows so it can be registered incrementally (e.g. with
+ * io_uring_register_buffers_update at the same index); the buffer index
+ * for READ_FIXED/WRITE_FIXED on an object is then slabIndexOf(obj). A slab
+ * freed by shrink() leaves an empty region at its index (reported through
+ * onSlabRemoved()) that a later slab may fill.
+ *
+ * @note Growth is geometric (each slab doubles the last) or linear (iSize
+ * slots per slab), optionally capped by Config::maxCapacity; at the cap,
+ * acquire() throws std::bad_alloc or returns nullptr per Config. shrink()
+ * gives fully idle slabs back after a spike.
  *
  * @note All objects acquired from the pool must be release()'d before the
  * pool itself is destroyed: the pool only owns raw storage, not object
  * lifetime, so it has no way to know which slots are still "live" (acquired
  * but not yet released) at teardown and cannot run their destructors for
- * them.
+ * them. Building with INK_ALLOCATOR_DEBUG reports any still-live slots
+ * at destruction, along with double releases, writes to released slots
+ * (freed storage is poisoned) and overruns past a slot (trailing canary).
  *
  * @tparam T The type of object to be stored in the pool.
  * @tparam iSize The initial number of objects to allocate in the first slab.
+ * @tparam Pages Huge-page policy for slabs. With anything but None every
+ * slab is mapped through PageAllocator in 2 MB-aligned multiples, and
+ * every slot that fits in the rounded slab is put to use.
  */
-template<typename T, usize iSize>
+template<typename T, usize iSize, PageAllocator::HugePages Pages = PageAllocator::None>
 class ObjectPool
 {
 public:
-    ObjectPool() : _currentCapacity(iSize) {
-        expand(_currentCapacity);
+    using SlabCallback = ink::move_only_function<void(size_t index, const SlabRegion& region)>;
+    using SlabRemovedCallback = ink::move_only_function<void(size_t index)>;
+
+    enum Growth {
+        Geometric, // each new slab doubles the previous one
+        Linear     // every slab holds iSize slots
+    };
+
+    enum Exhaustion {
+        Throw,     // acquire() throws std::bad_alloc
+        ReturnNull // acquire() returns nullptr
+    };
+
+    struct Config {
+        size_t maxCapacity = 0; // slot cap across all slabs; 0 = unbounded
+        Growth growth = Geometric;
+        Exhaustion onExhausted = Throw;
+        bool exportSlabs = false; // page-map every slab, the initial one included
+    };
+
+    // live is counted from the free list unless INK_ALLOCATOR_STATS keeps a
+    // running count; peakLive needs that count and reads 0 without it
+    struct Stats {
+        size_t live;     // acquired and not yet released
+        size_t peakLive;
+        size_t capacity; // slots across all slabs
+        size_t slabs;
+    };
+
+    ObjectPool() : ObjectPool(Config{})
+    {
+        // Empty
+    }
+
+    explicit ObjectPool(const Config& config) :
+        _freeHead(nullptr),
+        _bumpNext(nullptr),
+        _bumpEnd(nullptr),
+        _bumpSlab(kNoSlab),
+        _config(config),
+        _currentCapacity(0),
+        _capacity(0)
+#if INK_ALLOCATOR_STATS
+        , _live(0)
+        , _peakLive(0)
+#endif
+    {
+        if (!grow()) throw std::bad_alloc();
     }
 
     // avoid double-freeing the memory blocks
@@ -40,60 +136,347 @@ public:
     ObjectPool& operator=(const ObjectPool&) = delete;
 
     ~ObjectPool() {
-        for (void* block : _allBlocks) {
-            ::operator delete[](block, std::align_val_t(alignof(T)));
+#if INK_ALLOCATOR_DEBUG
+        for (size_t index = 0; index < _slabs.size(); ++index) {
+            Slot* slots = static_cast<Slot*>(_slabs[index].grant.memory);
+            Slot* end = slots + carved(index);
+            for (size_t i = 0; slots + i < end; ++i) {
+                if (slots[i].state == AllocatorDebug::kSlotLive)
+                    AllocatorDebug::report("object still live at pool destruction", slots[i].storage);
+                if (slots[i].canary != AllocatorDebug::kCanary)
+                    AllocatorDebug::report("slot overrun (canary clobbered)", slots[i].storage);
+            }
+        }
+#endif
+        for (const Slab& slab : _slabs) {
+            freeSlab(slab);
         }
     }
 
     // Acquires a free slot and constructs a T in place with the given
     // constructor arguments. O(1) amortized (occasionally expands the pool).
+    // At the capacity cap: throws std::bad_alloc, or returns nullptr with
+    // Config::onExhausted == ReturnNull.
     template<typename... Args>
     [[nodiscard]] T* acquire(Args&&... args) {
-        if (_freeList.empty()) 
-        {
-            _currentCapacity *= 2;
-            expand(_currentCapacity);
+        Slot* s = _freeHead;
+        if (s) {
+            _freeHead = s->next;
+#if INK_ALLOCATOR_DEBUG
+            if (!AllocatorDebug::isPoisoned(s->storage, sizeof(T)))
+                AllocatorDebug::report("write to released slot", s->storage);
+#endif
+        } else {
+            // Never-used slots are carved off the newest slab on demand
+            if (INK_UNLIKELY(_bumpNext == _bumpEnd) && !grow()) {
+                if (_config.onExhausted == ReturnNull) return nullptr;
+                throw std::bad_alloc();
+            }
+            s = _bumpNext++;
+#if INK_ALLOCATOR_DEBUG
+            s->canary = AllocatorDebug::kCanary;
+#endif
         }
-        T* slot = _freeList.back();
-        _freeList.pop_back();
-        return ::new (static_cast<void*>(slot)) T(std::forward<Args>(args)...);
+#if INK_ALLOCATOR_DEBUG
+        s->state = AllocatorDebug::kSlotLive;
+#endif
+        T* obj = ::new (static_cast<void*>(s->storage)) T(std::forward<Args>(args)...);
+#if INK_ALLOCATOR_STATS
+        if (++_live > _peakLive) _peakLive = _live;
+#endif
+        return obj;
     }
 
     // Destroys obj and returns its storage to the free list. obj must have
     // been returned by acquire() on this pool and not already released.
     void release(T* obj) {
+        Slot* s = slotOf(obj);
+#if INK_ALLOCATOR_DEBUG
+        if (s->state != AllocatorDebug::kSlotLive) {
+            AllocatorDebug::report("double release or foreign pointer", obj);
+            return;
+        }
+        obj->~T();
+        if (s->canary != AllocatorDebug::kCanary)
+            AllocatorDebug::report("slot overrun (canary clobbered)", obj);
+        s->canary = AllocatorDebug::kCanary;
+        std::memset(s->storage, AllocatorDebug::kPoison, sizeof(T));
+        s->state = AllocatorDebug::kSlotFree;
+#else
         obj->~T();
-        _freeList.push_back(obj);
+#endif
+#if INK_ALLOCATOR_STATS
+        --_live;
+#endif
+        s->next = _freeHead;
+        _freeHead = s;
+    }
+
+    // acquire() wrapped in a handle that releases the object when dropped.
+    // The handle is empty when acquire() returns nullptr.
+    template<typename... Args>
+    [[nodiscard]] PoolPtr<T> make(Args&&... args) {
+        return PoolPtr<T>(acquire(std::forward<Args>(args)...), this, &releaseThunk);
+    }
+
+    // Frees slabs with no live object, newest first, while at least
+    // keepSlots of capacity remain. The slots are attributed to slabs by
+    // walking the free list here, so acquire/release pay nothing for it.
+    // Returns the number of slots released.
+    size_t shrink(size_t keepSlots = 0) {
+        std::vector<size_t> freeSlots(_slabs.size(), 0);
+        const std::vector<size_t> order = slabsByAddress();
+        for (Slot* s = _freeHead; s; s = s->next) {
+            ++freeSlots[slabOf(order, s)];
+        }
+
+        std::vector<bool> idle(_slabs.size(), false);
+        size_t released = 0;
+        for (size_t index = _slabs.size(); index-- > 0; ) {
+            const Slab& slab = _slabs[index];
+            if (!slab.grant.memory || freeSlots[index] != carved(index)) continue;
+            if (_capacity - released - slab.slots < keepSlots) continue;
+            idle[index] = true;
+            released += slab.slots;
+        }
+        if (!released) return 0;
+
+        // Drop the idle slabs' slots from the free list, keeping its order
+        Slot** link = &_freeHead;
+        for (Slot* s = _freeHead; s; s = s->next) {
+            if (!idle[slabOf(order, s)]) {
+                *link = s;
+                link = &s->next;
+            }
+        }
+        *link = nullptr;
+
+        _currentCapacity = 0;
+        for (size_t index = 0; index < _slabs.size(); ++index) {
+            Slab& slab = _slabs[index];
+            if (!idle[index]) {
+                if (slab.grant.memory) _currentCapacity = INK_MAX(_currentCapacity, slab.slots);
+                continue;
+            }
+            freeSlab(slab);
+            slab = Slab{ PageAllocator::Grant{ nullptr, 0, PageAllocator::Small }, 0, false };
+            if (index == _bumpSlab) {
+                _bumpNext = _bumpEnd = nullptr;
+                _bumpSlab = kNoSlab;
+            }
+            if (_onSlabRemoved) _onSlabRemoved(index);
+        }
+        _capacity -= released;
+        return released;
+    }
+
+    Stats stats() const {
+        size_t slabs = 0;
+        for (const Slab& slab : _slabs) slabs += slab.grant.memory != nullptr;
+#if INK_ALLOCATOR_STATS
+        return Stats{ _live, _peakLive, _capacity, slabs };
+#else
+        size_t live = 0;
+        for (size_t index = 0; index < _slabs.size(); ++index) live += carved(index);
+        for (Slot* s = _freeHead; s; s = s->next) --live;
+        return Stats{ live, 0, _capacity, slabs };
+#endif
+    }
+
+    // Every slab index in order; indices are stable for the pool's life.
+    // A slab freed by shrink() shows as { nullptr, 0 } until reused. Slab 0
+    // is a heap block, not page aligned, unless Config::exportSlabs or huge
+    // pages are in use.
+    std::vector<SlabRegion> slabRegions() const {
+        std::vector<SlabRegion> regions;
+        regions.reserve(_slabs.size());
+        for (const Slab& slab : _slabs) {
+            regions.push_back(SlabRegion{ slab.grant.memory, slab.grant.bytes });
+        }
+        return regions;
+    }
+
+    // Called with (index, region) for each slab added from now on; the
+    // slabs that already exist are replayed first, so installing the
+    // callback right after construction sees the initial slab too. Slabs
+    // added while a callback is installed are page mapped; the replayed
+    // ones keep the placement they were made with (set
+    // Config::exportSlabs to have the initial slab mapped as well).
+    void onSlabAdded(SlabCallback callback) {
+        _onSlabAdded = std::move(callback);
+        if (_onSlabAdded) {
+            for (size_t i = 0; i < _slabs.size(); ++i) {
+                if (_slabs[i].grant.memory)
+                    _onSlabAdded(i, SlabRegion{ _slabs[i].grant.memory, _slabs[i].grant.bytes });
+            }
+        }
+    }
+
+    // Called with the index of each slab shrink() frees, before its index
+    // can be reused; unregister the buffer here
+    void onSlabRemoved(SlabRemovedCallback callback) {
+        _onSlabRemoved = std::move(callback);
+    }
+
+    // Index of the slab holding obj (its fixed-buffer index), or -1 if obj
+    // is not from this pool. Linear in the slab count, which only grows
+    // logarithmically with capacity.
+    isize slabIndexOf(const T* obj) const {
+        const u8* p = reinterpret_cast<const u8*>(obj);
+        for (size_t i = 0; i < _slabs.size(); ++i) {
+            const u8* base = static_cast<const u8*>(_slabs[i].grant.memory);
+            if (base && p >= base && p < base + _slabs[i].grant.bytes) return static_cast<isize>(i);
+        }
+        return -1;
     }
 
-    // Get fisrt block memory region
+    // Slab indices in use, including ones freed by shrink()
+    size_t slabCount() const { return _slabs.size(); }
+
+    // First slab (index 0); use slabRegions() to see every slab
     void* getRawBuffer() {
-        if (_allBlocks.empty()) return nullptr;
-        return _allBlocks[_allBlocks.size()-1];
+        if (_slabs.empty()) return nullptr;
+        return _slabs.front().grant.memory;
     }
 
     size_t getRawBufferSize() {
-        return _currentCapacity * sizeof(T);
+        if (_slabs.empty()) return 0;
+        return _slabs.front().grant.bytes;
+    }
+
+    // Page grant of the most recent slab (always Small without huge pages)
+    PageAllocator::Granted granted() const {
+        return _bumpSlab == kNoSlab ? PageAllocator::Small : _slabs[_bumpSlab].grant.granted;
     }
 
 private:
-    void expand(usize count) {
-        // Enforce the alignas(32) requirement when allocating the raw slab
-        // Make a big block of T* type space
-        T* block = static_cast<T*>(::operator new[](count * sizeof(T), std::align_val_t(alignof(T))));
-        _allBlocks.push_back(block);
-
-        // Push in reverse order so that 'acquire()' pops sequential addresses
-        // Insert each T* space of the block
-        for (isize i = count - 1; i >= 0; --i) 
-        {
-            _freeList.push_back(&block[i]);
+    // Storage for one T. A free slot holds the free-list link in its own
+    // storage, so the pool keeps no per-slot bookkeeping outside the slabs.
+    // Debug builds keep the link beside a live/free marker and a trailing
+    // canary instead, so the whole of storage can stay poisoned.
+#if INK_ALLOCATOR_DEBUG
+    struct Slot {
+        u64 state;
+        Slot* next;
+        alignas(T) u8 storage[sizeof(T)];
+        u64 canary;
+    };
+#else
+    struct Slot {
+        union {
+            Slot* next;
+            alignas(T) u8 storage[sizeof(T)];
+        };
+    };
+#endif
+
+    struct Slab {
+        PageAllocator::Grant grant; // memory == nullptr once shrunk away
+        size_t slots;               // usable slots (the cap may leave slack)
+        bool mapped;                // PageAllocator mapping, else heap
+    };
+
+    static constexpr size_t kNoSlab = static_cast<size_t>(-1);
+
+    static void releaseThunk(void* pool, T* obj) {
+        static_cast<ObjectPool*>(pool)->release(obj);
+    }
+
+    static void freeSlab(const Slab& slab) {
+        if (!slab.grant.memory) return;
+        if (slab.mapped) PageAllocator::unmap(slab.grant);
+        else ::operator delete(slab.grant.memory, std::align_val_t(alignof(Slot)));
+    }
+
+    static Slot* slotOf(T* obj) {
+        return reinterpret_cast<Slot*>(reinterpret_cast<u8*>(obj) - offsetof(Slot, storage));
+    }
+
+    // Slots ever handed out from a slab; only the bump slab has a tail
+    // that was never carved
+    size_t carved(size_t index) const {
+        if (index != _bumpSlab) return _slabs[index].slots;
+        return static_cast<size_t>(_bumpNext - static_cast<Slot*>(_slabs[index].grant.memory));
+    }
+
+    std::vector<size_t> slabsByAddress() const {
+        std::vector<size_t> order;
+        for (size_t i = 0; i < _slabs.size(); ++i) {
+            if (_slabs[i].grant.memory) order.push_back(i);
+        }
+        std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+            return _slabs[a].grant.memory < _slabs[b].grant.memory;
+        });
+        return order;
+    }
+
+    size_t slabOf(const std::vector<size_t>& order, const Slot* s) const {
+        auto it = std::upper_bound(order.begin(), order.end(), s, [this](const Slot* p, size_t index) {
+            return p < static_cast<const Slot*>(_slabs[index].grant.memory);
+        });
+        return *(it - 1);
+    }
+
+    // Adds the next slab per the growth policy; false at the cap or if the
+    // allocation fails
+    bool grow() {
+        usize count = (_config.growth == Linear || !_currentCapacity) ? iSize : _currentCapacity * 2;
+        if (_config.maxCapacity) {
+            if (_capacity >= _config.maxCapacity) return false;
+            count = INK_MIN(count, _config.maxCapacity - _capacity);
+        }
+        return expand(INK_MAX(count, usize(1)));
+    }
+
+    bool expand(usize count) {
+        // Huge pages and exported slabs come straight from the page
+        // allocator, so they are page aligned (what fixed-buffer
+        // registration pins) and every slot in the rounded-up mapping is
+        // used, up to the cap. Otherwise a plain heap block is enough.
+        const bool mapped = Pages != PageAllocator::None || _config.exportSlabs || static_cast<bool>(_onSlabAdded);
+        PageAllocator::Grant grant{ nullptr, count * sizeof(Slot), PageAllocator::Small };
+        if (mapped) {
+            static_assert(alignof(T) <= 4096, "slabs are only page aligned");
+            grant = PageAllocator::map(count * sizeof(Slot), Pages);
+        } else {
+            grant.memory = ::operator new(grant.bytes, std::align_val_t(alignof(Slot)), std::nothrow);
         }
+        if (!grant.memory) return false;
+        Slot* block = static_cast<Slot*>(grant.memory);
+        count = grant.bytes / sizeof(Slot);
+        if (_config.maxCapacity) count = INK_MIN(count, _config.maxCapacity - _capacity);
+        _currentCapacity = count;
+        _capacity += count;
+
+        // Reuse the first index shrink() freed, so indices stay dense
+        size_t index = 0;
+        while (index < _slabs.size() && _slabs[index].grant.memory) ++index;
+        if (index == _slabs.size()) _slabs.push_back(Slab{ grant, count, mapped });
+        else _slabs[index] = Slab{ grant, count, mapped };
+        if (_onSlabAdded) _onSlabAdded(index, SlabRegion{ grant.memory, grant.bytes });
+
+        // Slots are handed out in address order by acquire(); nothing in the
+        // slab is touched until then, so fresh pages stay unfaulted
+        _bumpNext = block;
+        _bumpEnd = block + count;
+        _bumpSlab = index;
+        return true;
     }
 
-    std::vector<T*> _freeList;
-    std::vector<void*> _allBlocks;
+    Slot* _freeHead;
+    Slot* _bumpNext;
+    Slot* _bumpEnd;
+    size_t _bumpSlab;
+    std::vector<Slab> _slabs;
+    SlabCallback _onSlabAdded;
+    SlabRemovedCallback _onSlabRemoved;
+    Config _config;
     usize _currentCapacity;
+    size_t _capacity;
+#if INK_ALLOCATOR_STATS
+    size_t _live;
+    size_t _peakLive;
+#endif
 };
 
 } // namespace ink
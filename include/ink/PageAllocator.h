@@ -0,0 +1,89 @@
+#ifndef PAGEALLOCATOR_H
+#define PAGEALLOCATOR_H
+
+#include <stddef.h>
+
+#include "ink/ink_base.hpp"
+
+namespace ink {
+
+/**
+ * @class PageAllocator
+ * @brief Anonymous page mappings with an opt-in huge-page policy, shared by
+ * InkedArena, ObjectPool and AlignedAllocator.
+ *
+ * Transparent mappings are 2 MB aligned and advised with MADV_HUGEPAGE so
+ * khugepaged (or the fault path) can back them with huge pages. Explicit
+ * mappings ask for MAP_HUGETLB from the reserved hugetlbfs pool and fall
+ * back to Transparent when the pool is empty or not configured. Other
+ * platforms map regular pages and report Small.
+ *
+ * A mapping can also be placed on a NUMA node: on Linux the range is
+ * mbind()'d with MPOL_PREFERRED before any page is touched (so the kernel
+ * still falls back to other nodes under memory pressure), on Windows it
+ * comes from VirtualAllocExNuma. Where that is unavailable (no NUMA
+ * syscalls, blocked by a sandbox, no such node) the mapping is left to
+ * first-touch placement and counted in Stats::numaFallbacks.
+ */
+class INK_API PageAllocator {
+public:
+    enum HugePages : u32
+    {
+        None = 0,
+        Transparent = 1, // 2 MB aligned + madvise(MADV_HUGEPAGE)
+        Explicit = 2     // MAP_HUGETLB, falling back to Transparent
+    };
+
+    // What a mapping actually received
+    enum Granted : u32
+    {
+        Small = 0,    // regular pages
+        Advised = 1,  // huge-page aligned and advised; the kernel decides
+        Huge = 2      // MAP_HUGETLB pages
+    };
+
+    struct Grant {
+        void* memory;
+        size_t bytes;   // mapped length; pass it back to unmap()
+        Granted granted;
+    };
+
+    // Process-wide totals of live mappings by grant, plus how often an
+    // Explicit request fell back
+    struct Stats {
+        u64 smallBytes;
+        u64 advisedBytes;
+        u64 hugeBytes;
+        u64 explicitFallbacks;
+        u64 numaFallbacks;   // node requests left to first-touch placement
+    };
+
+    static constexpr size_t kHugePageSize = size_t(2) << 20;
+    static constexpr int kNoNode = -1;
+
+    // Maps at least bytes (rounded up to the policy's page size) of zeroed
+    // read/write memory; populate backs it immediately (MAP_POPULATE), and
+    // node (when not kNoNode) places it on that NUMA node.
+    // memory is nullptr on failure.
+    static Grant map(size_t bytes, HugePages policy = None, bool populate = false, int node = kNoNode);
+    static void unmap(const Grant& grant);
+
+    // Length map() would produce for bytes under policy
+    static size_t roundUp(size_t bytes, HugePages policy);
+    static size_t pageSize();
+
+    // NUMA topology: number of possible nodes (1 without NUMA support) and
+    // the node of the CPU the calling thread is running on (0 if unknown)
+    static int numaNodeCount();
+    static int currentNumaNode();
+
+    // Highest id in a Linux list string such as "0", "0-3", "0,2" or
+    // "0-1,3" (the sysfs node/cpu list syntax); -1 if it holds no id
+    static int highestInList(const char* list);
+
+    static Stats stats();
+};
+
+} // namespace ink
+
+#endif // PAGEALLOCATOR_H
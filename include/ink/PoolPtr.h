@@ -0,0 +1,85 @@
+#ifndef POOLPTR_H
+#define POOLPTR_H
+
+#include <utility>
+
+#include "ink/ink_base.hpp"
+
+namespace ink {
+
+/**
+ * @class PoolPtr
+ * @brief Move-only owning handle to an object acquired from a pool.
+ *
+ * Works like std::unique_ptr with a pool-aware deleter: when the handle is
+ * destroyed or reset, the object goes back to the pool it came from, so a
+ * pooled object can neither be released twice nor leak on an early return.
+ * Obtain one from ObjectPool::make() or ConcurrentObjectPool::make().
+ *
+ * @note The pool must outlive every PoolPtr it hands out.
+ */
+template<typename T>
+class PoolPtr
+{
+public:
+    using Releaser = void (*)(void* pool, T* obj);
+
+    PoolPtr() noexcept : _obj(nullptr), _pool(nullptr), _release(nullptr)
+    {
+        // Empty
+    }
+
+    PoolPtr(T* obj, void* pool, Releaser release) noexcept :
+        _obj(obj),
+        _pool(pool),
+        _release(release)
+    {
+        // Empty
+    }
+
+    PoolPtr(PoolPtr&& other) noexcept :
+        _obj(std::exchange(other._obj, nullptr)),
+        _pool(other._pool),
+        _release(other._release)
+    {
+        // Empty
+    }
+
+    PoolPtr& operator=(PoolPtr&& other) noexcept {
+        if (this != &other) {
+            reset();
+            _obj = std::exchange(other._obj, nullptr);
+            _pool = other._pool;
+            _release = other._release;
+        }
+        return *this;
+    }
+
+    PoolPtr(const PoolPtr&) = delete;
+    PoolPtr& operator=(const PoolPtr&) = delete;
+
+    ~PoolPtr() { reset(); }
+
+    // Returns the object to its pool now; the handle becomes empty
+    void reset() noexcept {
+        if (_obj) _release(_pool, std::exchange(_obj, nullptr));
+    }
+
+    // Gives up ownership without releasing; the caller must hand the
+    // pointer back to the pool itself
+    [[nodiscard]] T* detach() noexcept { return std::exchange(_obj, nullptr); }
+
+    T* get() const noexcept { return _obj; }
+    T& operator*() const noexcept { return *_obj; }
+    T* operator->() const noexcept { return _obj; }
+    explicit operator bool() const noexcept { return _obj != nullptr; }
+
+private:
+    T* _obj;
+    void* _pool;
+    Releaser _release;
+};
+
+} // namespace ink
+
+#endif // POOLPTR_H
@@ -2,26 +2,80 @@
 #define QUEUE_H
 
 #include <mutex>
+#include <shared_mutex>
 #include <condition_variable>
 #include <queue>
 #include <atomic>
 #include <optional>
 #include <iterator>
+#include <vector>
+#include <chrono>
 
 #include "ink/ink_base.hpp"
+#include "ink/CachePadded.h"
 
 namespace ink {
 
+/**
+ * @class QueueNotifier
+ * @brief Epoch-counting wakeup shared by several queues.
+ *
+ * Every push/shutdown on an attached Queue bumps the epoch. A waiter reads
+ * epoch(), checks its queues, and only then blocks in wait_for_change(),
+ * so a push landing between the check and the wait is never lost.
+ */
+class INK_API QueueNotifier {
+private:
+    mutable std::mutex mutex_;
+    std::condition_variable cond_;
+    u64 epoch_;
+
+public:
+    QueueNotifier() : epoch_(0) {}
+
+    QueueNotifier(const QueueNotifier&) = delete;
+    QueueNotifier& operator=(const QueueNotifier&) = delete;
+
+    void notify() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++epoch_;
+        }
+        cond_.notify_all();
+    }
+
+    u64 epoch() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return epoch_;
+    }
+
+    void wait_for_change(u64 seen) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this, seen] { return epoch_ != seen; });
+    }
+
+    // Returns false on timeout
+    template<typename Clock, typename Duration>
+    bool wait_for_change_until(u64 seen, const std::chrono::time_point<Clock, Duration>& deadline) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cond_.wait_until(lock, deadline, [this, seen] { return epoch_ != seen; });
+    }
+};
+
 template<typename T>
 class INK_API Queue {
 private:
     mutable std::mutex mutex_;
     std::queue<T> data_queue_;
     std::condition_variable data_cond_;
-    std::atomic<bool> done_;
+    // Polled lock-free by is_shutdown(); kept off the line every push/pop
+    // writes through mutex_
+    CachePadded<std::atomic<bool>> done_;
+    // Set by QueueSet; signalled under mutex_ so a set can detach safely
+    QueueNotifier* notifier_;
 
 public:
-    Queue() : done_(false) {}
+    Queue() : done_(std::in_place, false), notifier_(nullptr) {}
 
     Queue(const Queue&) = delete;
     Queue& operator=(const Queue&) = delete;
@@ -34,6 +88,7 @@ public:
         std::lock_guard<std::mutex> lock(mutex_);
         data_queue_.push(std::move(new_value));
         data_cond_.notify_one();
+        if (notifier_) notifier_->notify();
     }
 
     template<typename Iterator>
@@ -46,12 +101,13 @@ public:
         for (size_t i = 0; i < count; ++i) {
             data_cond_.notify_one();
         }
+        if (count > 0 && notifier_) notifier_->notify();
     }
 
     bool wait_and_pop(T& value) {
         std::unique_lock<std::mutex> lock(mutex_);
         data_cond_.wait(lock, [this] {
-            return !data_queue_.empty() || done_;
+            return !data_queue_.empty() || *done_;
         });
 
         if (data_queue_.empty()) {
@@ -90,7 +146,7 @@ public:
         std::unique_lock<std::mutex> lock(mutex_);
 
         if (!data_cond_.wait_for(lock, timeout, [this] {
-                return !data_queue_.empty() || done_;
+                return !data_queue_.empty() || *done_;
             })) {
             return false;
         }
@@ -117,13 +173,159 @@ public:
     void shutdown() {
         {
             std::lock_guard<std::mutex> lock(mutex_);
-            done_ = true;
+            *done_ = true;
+            if (notifier_) notifier_->notify();
         }
         data_cond_.notify_all();
     }
 
     bool is_shutdown() const {
-        return done_;
+        return *done_;
+    }
+
+    // A queue can belong to at most one QueueSet at a time: returns false
+    // (and changes nothing) if a notifier is already attached. Passing
+    // nullptr detaches it and always succeeds.
+    bool set_notifier(QueueNotifier* notifier) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (notifier && notifier_) return false;
+        notifier_ = notifier;
+        return true;
+    }
+};
+
+/**
+ * @class QueueSet
+ * @brief Blocks on several Queue<T> instances (of any element types) at once.
+ *
+ * wait() returns the index of a queue that has data, or std::nullopt once
+ * every member has been shut down and drained. The scan starts one past the
+ * last index returned, so a busy queue cannot starve the others.
+ *
+ * The returned queue is only "ready" at the time of the scan: with several
+ * consumers another thread may pop first, so follow up with try_pop().
+ * Several threads may wait on one set, and add() may run concurrently with
+ * them: it wakes blocked waiters so the new queue is scanned straight away.
+ *
+ * @note Member queues must outlive the set (or be detached by destroying
+ * the set first).
+ */
+class INK_API QueueSet {
+private:
+    struct Entry {
+        void* queue;
+        bool (*has_data)(const void*);
+        bool (*is_shutdown)(const void*);
+        void (*detach)(void*);
+    };
+
+    QueueNotifier notifier_;
+    // Shared by scans (never across a blocking wait), exclusive in add()
+    mutable std::shared_mutex entries_mutex_;
+    std::vector<Entry> entries_;
+    // Scan start; consumers race on it, which only affects fairness
+    std::atomic<size_t> next_;
+
+    template<typename T>
+    static bool has_data_of(const void* q) { return !static_cast<const Queue<T>*>(q)->empty(); }
+
+    template<typename T>
+    static bool is_shutdown_of(const void* q) { return static_cast<const Queue<T>*>(q)->is_shutdown(); }
+
+    template<typename T>
+    static void detach_of(void* q) { static_cast<Queue<T>*>(q)->set_notifier(nullptr); }
+
+    // Ready index, or npos when nothing is ready yet; all_done reports
+    // whether every queue is shut down and empty.
+    size_t scan(bool& all_done) {
+        std::shared_lock<std::shared_mutex> lock(entries_mutex_);
+        const size_t n = entries_.size();
+        const size_t start = next_.load(std::memory_order_relaxed);
+        all_done = true;
+        for (size_t i = 0; i < n; ++i) {
+            const size_t idx = (start + i) % n;
+            const Entry& e = entries_[idx];
+            if (e.has_data(e.queue)) {
+                next_.store(idx + 1, std::memory_order_relaxed);
+                all_done = false;
+                return idx;
+            }
+            if (!e.is_shutdown(e.queue)) all_done = false;
+        }
+        return npos;
+    }
+
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    QueueSet() : next_(0) {}
+
+    QueueSet(const QueueSet&) = delete;
+    QueueSet& operator=(const QueueSet&) = delete;
+
+    ~QueueSet() {
+        for (Entry& e : entries_) {
+            e.detach(e.queue);
+        }
+    }
+
+    // Returns the index wait() will report for this queue, or npos if the
+    // queue already belongs to a set (this one included). Safe to call while
+    // other threads are inside wait(), wait_for() or try_select().
+    template<typename T>
+    size_t add(Queue<T>& queue) {
+        size_t idx = npos;
+        {
+            std::unique_lock<std::shared_mutex> lock(entries_mutex_);
+            if (!queue.set_notifier(&notifier_)) return npos;
+            try {
+                entries_.push_back(Entry{ &queue, &has_data_of<T>, &is_shutdown_of<T>, &detach_of<T> });
+            } catch (...) {
+                queue.set_notifier(nullptr);
+                throw;
+            }
+            idx = entries_.size() - 1;
+        }
+        // Waiters that found nothing (or every old member done) rescan
+        notifier_.notify();
+        return idx;
+    }
+
+    size_t size() const {
+        std::shared_lock<std::shared_mutex> lock(entries_mutex_);
+        return entries_.size();
+    }
+
+    std::optional<size_t> wait() {
+        while (true) {
+            const u64 seen = notifier_.epoch();
+            bool all_done = false;
+            const size_t idx = scan(all_done);
+            if (idx != npos) return idx;
+            if (all_done) return std::nullopt;
+            notifier_.wait_for_change(seen);
+        }
+    }
+
+    // std::nullopt on timeout as well as when every queue is shut down
+    template<typename Rep, typename Period>
+    std::optional<size_t> wait_for(const std::chrono::duration<Rep, Period>& timeout) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (true) {
+            const u64 seen = notifier_.epoch();
+            bool all_done = false;
+            const size_t idx = scan(all_done);
+            if (idx != npos) return idx;
+            if (all_done) return std::nullopt;
+            if (!notifier_.wait_for_change_until(seen, deadline)) return std::nullopt;
+        }
+    }
+
+    std::optional<size_t> try_select() {
+        bool all_done = false;
+        const size_t idx = scan(all_done);
+        if (idx == npos) return std::nullopt;
+        return idx;
     }
 };
 
@@ -2,7 +2,9 @@
 #define RINGBUFFER_H
 
 #include <math.h>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "ink/ink_base.hpp"
@@ -11,16 +13,58 @@ namespace ink {
 
 class INK_API RingBuffer {
 public:
-    explicit RingBuffer(size_t capacity = 8192);
+    enum Options : u32
+    {
+        Default = 0,
+        // Map the same pages twice back-to-back so every readable/writable
+        // region is contiguous. Capacity is rounded up to the page size.
+        // Falls back to Default where memfd mappings are unavailable.
+        Mirrored = 1 << 0,
+        // Round capacity up to a power of two so positions map to slots
+        // with a mask instead of an integer division. Any capacity that is
+        // already a power of two takes the masked path without this flag.
+        PowerOfTwo = 1 << 1
+    };
 
-    ~RingBuffer() = default;
+    // Readable bytes as at most two segments: second is non-empty only when
+    // the range crosses the physical end (never in mirrored mode). Views
+    // stay valid until the bytes are consumed or overwritten, or until a
+    // write-side call reallocates (write, reserve, readFrom or
+    // shrinkToFit on a ring with a GrowthPolicy). Reads never reallocate.
+    struct View
+    {
+        std::string_view first;
+        std::string_view second;
+
+        size_t size() const { return first.size() + second.size(); }
+        bool empty() const { return size() == 0; }
+        bool contiguous() const { return second.empty(); }
+        char operator[](size_t i) const { return i < first.size() ? first[i] : second[i - first.size()]; }
+        // Copies both segments into dest (at least size() bytes)
+        size_t copyTo(char* dest) const;
+    };
+
+    // Opt-in elastic sizing. write()/reserve()/readFrom() double the
+    // capacity (linearizing the data) instead of truncating, up to
+    // maxCapacity; after shrinkAfterReads consecutive reads that leave the
+    // ring at most a quarter full, the next write-side call halves the
+    // capacity again, never below the constructed capacity.
+    struct GrowthPolicy
+    {
+        size_t maxCapacity = 0;     // <= capacity() keeps the ring fixed-size
+        u32 shrinkAfterReads = 256; // 0 never shrinks automatically
+    };
+
+    explicit RingBuffer(size_t capacity = 8192, u32 options = Default);
+
+    ~RingBuffer();
 
     // Non-copyable
     RingBuffer(const RingBuffer&) = delete;
     RingBuffer& operator=(const RingBuffer&) = delete;
 
-    RingBuffer(RingBuffer&&) noexcept = default;
-    RingBuffer& operator=(RingBuffer&&) noexcept = default;
+    RingBuffer(RingBuffer&& other) noexcept;
+    RingBuffer& operator=(RingBuffer&& other) noexcept;
 
     // Read data from the buffer
     size_t read(char* dest, size_t maxLen);
@@ -29,9 +73,11 @@ public:
     size_t write(std::string_view sv);
     size_t write(const std::string& s);
 
-    // Get a contiguous read buffer (for zero-copy operations)
+    // Get a contiguous read buffer (for zero-copy operations).
+    // In mirrored mode this covers every readable byte.
     const char* getReadBuffer(size_t& availableData) const;
-    // Get a contiguous write buffer (for zero-copy operations)
+    // Get a contiguous write buffer (for zero-copy operations).
+    // In mirrored mode this covers all free space.
     char* getWriteBuffer(size_t& availableSpace);
     // Advance read position after reading data
     void advanceReadPos(size_t len);
@@ -40,18 +86,82 @@ public:
     // Clear buffer
     void clear();
 
+    // maxCapacity is rounded down to what the ring's options can allocate
+    // (a power of two, whole pages when mirrored)
+    void setGrowthPolicy(const GrowthPolicy& policy);
+    const GrowthPolicy& growthPolicy() const { return _growth; }
+    // Ensures len contiguous-or-not writable bytes, growing if the policy
+    // allows. Returns false, without growing, when the cap prevents it.
+    bool reserve(size_t len);
+    // Shrinks towards the constructed capacity (keeping at least size()
+    // bytes); useful for idle connections that no longer read
+    void shrinkToFit();
+
+    // Non-consuming view of up to len readable bytes starting offset bytes
+    // past the read position
+    View peek(size_t offset, size_t len) const;
+    // Offset (from the read position) of the first occurrence of delim at
+    // or after `from`, including matches that straddle the wrap point
+    std::optional<size_t> findDelimiter(std::string_view delim, size_t from = 0) const;
+    // Payload of the next length-prefixed frame without consuming it. The
+    // prefix is an unsigned big-endian integer of lengthPrefixBytes (1..8)
+    // bytes; std::nullopt until the whole frame has arrived. Consume it
+    // with advanceReadPos(lengthPrefixBytes + view.size()).
+    std::optional<View> peekFrame(size_t lengthPrefixBytes) const;
+
+#if !defined(INK_PLATFORM_WINDOWS)
+    // Fill the ring straight from fd with one readv() over the (up to two)
+    // free segments. Returns bytes read, 0 on EOF, -1 on error with errno
+    // set (EAGAIN included for non-blocking fds). A full() ring that cannot
+    // grow, or maxLen == 0, returns -1 with errno = ENOBUFS and leaves fd
+    // untouched, so 0 always means EOF.
+    isize readFrom(int fd, size_t maxLen = static_cast<size_t>(-1));
+    // Drain the ring straight into fd with one writev() over the (up to
+    // two) readable segments. Returns bytes written, 0 when empty(), -1 on
+    // error with errno set.
+    isize writeTo(int fd, size_t maxLen = static_cast<size_t>(-1));
+#endif
+
     // Utility methods
-    size_t size() const { return _size; }
+    size_t size() const { return static_cast<size_t>(_writePos - _readPos); }
     size_t capacity() const { return _capacity; }
-    bool empty() const { return _size == 0; }
-    bool full() const { return _size == _capacity; }
+    bool empty() const { return _writePos == _readPos; }
+    bool full() const { return size() == _capacity; }
+    bool mirrored() const { return _mirror != nullptr; }
 
 private:
+    // (Re)allocates storage of the requested capacity, honouring _options
+    void allocate(size_t capacity);
+    // Moves the readable bytes to the start of a new allocation
+    void reallocate(size_t capacity);
+    bool growFor(size_t len);
+    void noteDrain();
+    // Halves capacity after a run of low reads if size() + len still fits
+    void applyShrink(size_t len);
+    void releaseMirror() noexcept;
+
+    // Slot for a free-running position
+    size_t index(u64 pos) const
+    {
+        return _mask ? static_cast<size_t>(pos & _mask) : static_cast<size_t>(pos % _capacity);
+    }
+
     std::vector<char> _buffer;
+    // Base of the double mapping (2 * _capacity bytes), nullptr when flat
+    char* _mirror;
+    char* _data;
     size_t _capacity;
-    size_t _readPos;
-    size_t _writePos;
-    size_t _size;
+    // capacity - 1 when capacity is a power of two, else 0
+    size_t _mask;
+    // Free-running counters: size is their difference, slots come from index()
+    u64 _readPos;
+    u64 _writePos;
+
+    u32 _options;
+    size_t _minCapacity;
+    GrowthPolicy _growth;
+    u32 _lowStreak;
+    bool _shrinkPending;
 };
 
 }
@@ -0,0 +1,155 @@
+#ifndef SLOTMAP_H
+#define SLOTMAP_H
+
+#include <utility>
+#include <vector>
+
+#include "ink/ink_base.hpp"
+
+namespace ink {
+
+/**
+ * @class SlotMap
+ * @brief Generational slot map: stable 32-bit index + generation handles to
+ * objects kept densely packed for iteration.
+ *
+ * Values live contiguously in insertion order (erase moves the last value
+ * into the hole), so iterating live objects is a linear walk with no
+ * tombstones. A sparse slot table maps a handle's index to the value's
+ * dense position and carries the slot generation: it is bumped on insert
+ * and on erase, so live slots have odd generations and a handle to an
+ * erased (or reused) slot fails validation in O(1) instead of aliasing the
+ * new occupant. Freed slots are reused through an intrusive free list.
+ *
+ * Store Handles in other structures, not T*: pointers and iterators are
+ * invalidated by insert and erase, handles only by erasing their object.
+ *
+ * @tparam T The type of object stored. Must be move-constructible and
+ * move-assignable.
+ */
+template<typename T>
+class SlotMap
+{
+public:
+    struct Handle {
+        u32 index = 0;
+        u32 generation = 0; // 0 (even) never names a live object
+
+        bool operator==(const Handle&) const = default;
+        explicit operator bool() const { return generation != 0; }
+    };
+
+    SlotMap() : _freeHead(kNone)
+    {
+        // Empty
+    }
+
+    // Constructs a T in place and returns its handle. If construction (or
+    // growing the tables) throws, the map is left unchanged.
+    template<typename... Args>
+    Handle insert(Args&&... args) {
+        _values.emplace_back(std::forward<Args>(args)...);
+
+        // The free slot is only taken once nothing else can throw
+        const bool reuse = _freeHead != kNone;
+        const u32 index = reuse ? _freeHead : static_cast<u32>(_slots.size());
+        try {
+            _owners.push_back(index);
+            if (!reuse) _slots.push_back(Slot{ 0, 0 });
+        } catch (...) {
+            if (_owners.size() == _values.size()) _owners.pop_back();
+            _values.pop_back();
+            throw;
+        }
+        if (reuse) _freeHead = _slots[index].dense;
+
+        Slot& slot = _slots[index];
+        slot.dense = static_cast<u32>(_values.size() - 1);
+        ++slot.generation;
+        return Handle{ index, slot.generation };
+    }
+
+    // Destroys the object behind h; false if h is stale or null
+    bool erase(Handle h) {
+        if (!contains(h)) return false;
+        Slot& slot = _slots[h.index];
+        const u32 hole = slot.dense;
+        const u32 last = static_cast<u32>(_values.size() - 1);
+        if (hole != last) {
+            _values[hole] = std::move(_values[last]);
+            _owners[hole] = _owners[last];
+            _slots[_owners[hole]].dense = hole;
+        }
+        _values.pop_back();
+        _owners.pop_back();
+
+        ++slot.generation;
+        slot.dense = _freeHead;
+        _freeHead = h.index;
+        return true;
+    }
+
+    bool contains(Handle h) const {
+        return (h.generation & 1) && h.index < _slots.size() && _slots[h.index].generation == h.generation;
+    }
+
+    // Validated lookup; nullptr if h is stale or null
+    T* get(Handle h) {
+        return contains(h) ? &_values[_slots[h.index].dense] : nullptr;
+    }
+
+    const T* get(Handle h) const {
+        return contains(h) ? &_values[_slots[h.index].dense] : nullptr;
+    }
+
+    // Handle of the object at dense position i (0 <= i < size()), e.g. to
+    // erase while iterating
+    Handle handleAt(size_t i) const {
+        const u32 index = _owners[i];
+        return Handle{ index, _slots[index].generation };
+    }
+
+    // Erases everything; every outstanding handle becomes stale
+    void clear() {
+        for (u32 index : _owners) {
+            Slot& slot = _slots[index];
+            ++slot.generation;
+            slot.dense = _freeHead;
+            _freeHead = index;
+        }
+        _values.clear();
+        _owners.clear();
+    }
+
+    void reserve(size_t n) {
+        _values.reserve(n);
+        _owners.reserve(n);
+        _slots.reserve(n);
+    }
+
+    size_t size() const { return _values.size(); }
+    bool empty() const { return _values.empty(); }
+
+    // Dense iteration over live objects (order changes on erase)
+    T* begin() { return _values.data(); }
+    T* end() { return _values.data() + _values.size(); }
+    const T* begin() const { return _values.data(); }
+    const T* end() const { return _values.data() + _values.size(); }
+
+private:
+    static constexpr u32 kNone = 0xFFFFFFFFu;
+
+    struct Slot {
+        u32 generation; // odd while live
+        u32 dense;      // position in _values, or next free slot
+    };
+
+    std::vector<T> _values;
+    std::vector<u32> _owners; // slot index of each dense value
+    std::vector<Slot> _slots;
+    u32 _freeHead;
+};
+
+} // namespace ink
+
+#endif // SLOTMAP_H
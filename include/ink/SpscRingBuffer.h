@@ -0,0 +1,100 @@
+#ifndef SPSCRINGBUFFER_H
+#define SPSCRINGBUFFER_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "ink/ink_base.hpp"
+#include "ink/CachePadded.h"
+
+namespace ink {
+
+/**
+ * @class SpscRingBuffer
+ * @brief Lock-free single-producer/single-consumer byte ring.
+ *
+ * Same zero-copy surface as RingBuffer, but safe to share between exactly
+ * one producer thread (write/getWriteBuffer/advanceWritePos) and one
+ * consumer thread (read/getReadBuffer/advanceReadPos).
+ *
+ * Read and write positions are free-running 64-bit counters, each on its
+ * own cache line next to the owning side's cached copy of the other
+ * counter, so the fast path only touches the other side's line when the
+ * cached view cannot satisfy the request. Capacity is rounded up to a power of two
+ * and indices are masked.
+ */
+class INK_API SpscRingBuffer {
+public:
+    enum Options : u32
+    {
+        Default = 0,
+        // Publishing sides bump a shared wakeup epoch so threads parked in
+        // waitForData/waitForSpace sleep in std::atomic::wait. Without it
+        // those waits spin and yield instead, and the hot path never touches
+        // the epoch line.
+        Blocking = 1 << 0
+    };
+
+    explicit SpscRingBuffer(size_t capacity = 8192, u32 options = Default);
+
+    ~SpscRingBuffer() = default;
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    // Producer side
+    size_t write(const char* data, size_t len);
+    size_t write(std::string_view sv) { return write(sv.data(), sv.size()); }
+    char* getWriteBuffer(size_t& availableSpace);
+    void advanceWritePos(size_t len);
+    // Blocks until at least minSpace bytes are free; false once closed
+    bool waitForSpace(size_t minSpace = 1);
+
+    // Consumer side
+    size_t read(char* dest, size_t maxLen);
+    const char* getReadBuffer(size_t& availableData);
+    void advanceReadPos(size_t len);
+    // Blocks until at least minData bytes are readable; false once closed
+    // and fewer than minData bytes remain
+    bool waitForData(size_t minData = 1);
+
+    // Either side: wakes every waiter; the consumer can still drain
+    void close();
+    bool closed() const { return _closed.load(std::memory_order_acquire); }
+
+    // Snapshots; exact only when called from a side that is not racing
+    size_t size() const;
+    size_t capacity() const { return _capacity; }
+    bool empty() const { return size() == 0; }
+
+private:
+    // Free/used bytes from the cached opposite counter, refreshed only when
+    // the cached view cannot satisfy `wanted`
+    size_t freeSpace(u64 writePos, size_t wanted);
+    size_t usedSpace(u64 readPos, size_t wanted);
+    void publish(std::atomic<u64>& counter, u64 value);
+    void signal();
+
+    // Producer-owned line
+    alignas(kCacheLineSize) std::atomic<u64> _writePos;
+    u64 _cachedReadPos;
+
+    // Consumer-owned line
+    alignas(kCacheLineSize) std::atomic<u64> _readPos;
+    u64 _cachedWritePos;
+
+    // Wakeup epoch, only written in Blocking mode and by close()
+    alignas(kCacheLineSize) std::atomic<u32> _signal;
+
+    // Read-only after construction
+    alignas(kCacheLineSize) std::vector<char> _buffer;
+    size_t _capacity;
+    size_t _mask;
+    bool _blocking;
+    std::atomic<bool> _closed;
+};
+
+}
+
+#endif // SPSCRINGBUFFER_H
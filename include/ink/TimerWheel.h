@@ -11,17 +11,46 @@ struct TimerNode {
     TimerNode* prev = nullptr;
     TimerNode* next = nullptr;
     u32 slotIndex = 0;
+    u64 expires = 0; // absolute tick the node fires on
 };
 
+/**
+ * @class TimerWheel
+ * @brief Hierarchical timing wheel over intrusive TimerNodes.
+ *
+ * Four levels of 64 slots cover 64^4 ticks (about 4.6 hours at 1 ms per
+ * tick, 194 days at 1 s). Level 0 holds timers due within 64 ticks, one
+ * tick per slot; each higher level spans 64 times the one below. When the
+ * level-0 hand wraps, the next level's current slot is cascaded down,
+ * re-filing each node by its remaining delay. Insert and cancel are O(1)
+ * for any delay, and each node cascades at most once per level. Longer
+ * delays are parked on the top level and re-filed until they come in range.
+ *
+ * Every node can carry its own timeout (schedule / scheduleAfterMillis);
+ * update() keeps the fixed ticksToLive from construction.
+ */
 class TimerWheel {
 public:
+    static constexpr u32 kLevels = 4;
+    static constexpr u32 kSlotBits = 6;
+    static constexpr u32 kSlots = 1u << kSlotBits;
+    static constexpr u64 kMaxTicks = u64(1) << (kLevels * kSlotBits); // delays below need no re-filing
+
     // Resolution: 1 tick per second (or 100ms)
-    // Size: 60 slots (for 60 seconds timeout)
+    // ticksToLive: the timeout update() schedules with (60 ticks = 60 s)
     TimerWheel(u32 ticksToLive = 60, u32 tickIntervalMs = 1000);
 
-    // O(1) - Add or Update session
+    // O(1) - Add or Update session, expiring ticksToLive ticks from now
     void update(TimerNode* node);
 
+    // O(1) - (Re)schedule node to be returned by the tick() call `ticks`
+    // calls from now (0 = the very next tick())
+    void schedule(TimerNode* node, u64 ticks);
+
+    // O(1) - (Re)schedule node on the first tick at or after nowMs + delayMs
+    void scheduleAfterMillis(TimerNode* node, u64 delayMs, u64 nowMs);
+    void scheduleAfterMillis(TimerNode* node, u64 delayMs);
+
     // O(1) - Remove session (e.g., on explicit close)
     void unlink(TimerNode* node);
 
@@ -47,15 +76,23 @@ public:
         }
     }
 
+    // Ticks processed so far (the tick the next tick() call handles)
+    u64 now() const { return _now; }
+
     u64 getNextTickTime() const { return _lastTickMs + _tickMs; }
 
     u64 timeToNextTickMillis(const u64& nowMs) const;
 
 private:
+    // Files node by its remaining delay; it must not be linked
+    void link(TimerNode* node);
+
+    // Re-files every node of `level`'s current slot
+    void cascade(u32 level);
+
     u32 _ticksToLive;
-    std::vector<TimerNode*> _wheel;
-    u32 _wheelMask;
-    u32 _currentSlot;
+    std::vector<TimerNode*> _wheel; // kLevels * kSlots heads, level-major
+    u64 _now;
 
     u64 _tickMs;
     u64 _lastTickMs;
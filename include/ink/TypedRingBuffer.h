@@ -0,0 +1,220 @@
+#ifndef TYPEDRINGBUFFER_H
+#define TYPEDRINGBUFFER_H
+
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "ink/ink_base.hpp"
+#include "ink/CachePadded.h"
+
+namespace ink {
+
+/**
+ * @class TypedRingBuffer
+ * @brief Fixed-capacity ring of T records (the typed sibling of RingBuffer).
+ *
+ * Elements are constructed in place in a single aligned slab and addressed
+ * through free-running counters with a power-of-two mask, so there is no
+ * memcpy serialization and no per-element allocation.
+ *
+ * With Policy::OverwriteOldest a push into a full ring destroys the oldest
+ * record instead of failing, which keeps a "last N samples" window without
+ * ever blocking the producer. The new record can only go into the oldest
+ * one's slot, so it is built first and moved in after the drop; that move
+ * must not throw, so the policy requires a nothrow-movable T (the
+ * constructor throws std::invalid_argument otherwise). A throwing
+ * constructor then leaves a full ring untouched.
+ *
+ * @note Not thread-safe; see SpscRingBuffer for a cross-thread byte pipe.
+ *
+ * @tparam T Record type.
+ */
+template<typename T>
+class TypedRingBuffer
+{
+public:
+    enum Policy
+    {
+        RejectWhenFull = 0, // push/emplace return false when full
+        OverwriteOldest = 1 // push/emplace drop the oldest record when full
+    };
+
+    // Capacity is rounded up to a power of two. OverwriteOldest needs T to
+    // be nothrow move constructible.
+    explicit TypedRingBuffer(size_t capacity = 1024, Policy policy = RejectWhenFull) :
+        _capacity(detail::roundPow2(INK_MAX(capacity, size_t(1)))),
+        _mask(_capacity - 1),
+        _readPos(0),
+        _writePos(0),
+        _overwritten(0),
+        _policy(policy)
+    {
+        if (policy == OverwriteOldest && !std::is_nothrow_move_constructible_v<T>)
+            throw std::invalid_argument("TypedRingBuffer: OverwriteOldest needs a nothrow-movable T");
+        _slots = static_cast<T*>(::operator new(_capacity * sizeof(T), std::align_val_t(alignof(T))));
+    }
+
+    ~TypedRingBuffer() {
+        release();
+    }
+
+    TypedRingBuffer(const TypedRingBuffer&) = delete;
+    TypedRingBuffer& operator=(const TypedRingBuffer&) = delete;
+
+    TypedRingBuffer(TypedRingBuffer&& other) noexcept :
+        _slots(std::exchange(other._slots, nullptr)),
+        _capacity(std::exchange(other._capacity, 0)),
+        _mask(std::exchange(other._mask, 0)),
+        _readPos(std::exchange(other._readPos, 0)),
+        _writePos(std::exchange(other._writePos, 0)),
+        _overwritten(std::exchange(other._overwritten, 0)),
+        _policy(other._policy)
+    {
+    }
+
+    TypedRingBuffer& operator=(TypedRingBuffer&& other) noexcept {
+        if (this != &other) {
+            release();
+            _slots = std::exchange(other._slots, nullptr);
+            _capacity = std::exchange(other._capacity, 0);
+            _mask = std::exchange(other._mask, 0);
+            _readPos = std::exchange(other._readPos, 0);
+            _writePos = std::exchange(other._writePos, 0);
+            _overwritten = std::exchange(other._overwritten, 0);
+            _policy = other._policy;
+        }
+        return *this;
+    }
+
+    // Constructs a record at the back. Returns false when full under
+    // RejectWhenFull, and always on a moved-from ring (it has no slots).
+    template<typename... Args>
+    bool emplace(Args&&... args) {
+        if (INK_UNLIKELY(!_slots)) return false;
+        if (full()) {
+            if (_policy == RejectWhenFull) return false;
+            // The arguments may refer to the oldest record (push(ring[0]),
+            // push(*peek())), so build the value before dropping it; a
+            // throwing constructor then leaves the ring untouched, and the
+            // move into the freed slot cannot throw (checked at construction)
+            T value(std::forward<Args>(args)...);
+            pop();
+            ::new (static_cast<void*>(slot(_writePos))) T(std::move(value));
+            ++_writePos;
+            ++_overwritten;
+            return true;
+        }
+        ::new (static_cast<void*>(slot(_writePos))) T(std::forward<Args>(args)...);
+        ++_writePos;
+        return true;
+    }
+
+    bool push(const T& value) { return emplace(value); }
+    bool push(T&& value) { return emplace(std::move(value)); }
+
+    // Oldest record, nullptr when empty
+    T* peek() { return empty() ? nullptr : slot(_readPos); }
+    const T* peek() const { return empty() ? nullptr : slot(_readPos); }
+
+    // i-th oldest record; i must be < size()
+    T& operator[](size_t i) { return *slot(_readPos + i); }
+    const T& operator[](size_t i) const { return *slot(_readPos + i); }
+
+    // Destroys the oldest record
+    bool pop() {
+        if (empty()) return false;
+        slot(_readPos)->~T();
+        ++_readPos;
+        return true;
+    }
+
+    // Moves the oldest record into out
+    bool pop(T& out) {
+        if (empty()) return false;
+        out = std::move(*slot(_readPos));
+        return pop();
+    }
+
+    // Moves up to out.size() oldest records into out; returns the count
+    size_t pop_n(std::span<T> out) {
+        const size_t n = INK_MIN(out.size(), size());
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = std::move(*slot(_readPos));
+            pop();
+        }
+        return n;
+    }
+
+    // Oldest contiguous run of records (stops at the physical end of the
+    // slab); follow with consume() once processed.
+    std::span<T> readSpan() {
+        const size_t idx = static_cast<size_t>(_readPos & _mask);
+        return std::span<T>(_slots + idx, INK_MIN(size(), _capacity - idx));
+    }
+
+    std::span<const T> readSpan() const {
+        const size_t idx = static_cast<size_t>(_readPos & _mask);
+        return std::span<const T>(_slots + idx, INK_MIN(size(), _capacity - idx));
+    }
+
+    // Destroys the n oldest records
+    void consume(size_t n) {
+        n = INK_MIN(n, size());
+        if constexpr (std::is_trivially_destructible_v<T>) {
+            _readPos += n;
+        } else {
+            for (size_t i = 0; i < n; ++i) pop();
+        }
+    }
+
+    // Contiguous free slots at the back for batch producers; fill them and
+    // commit(n). Restricted to trivially copyable records since the slots
+    // hold no live objects until committed.
+    std::span<T> writeSpan() requires std::is_trivially_copyable_v<T> {
+        const size_t idx = static_cast<size_t>(_writePos & _mask);
+        return std::span<T>(_slots + idx, INK_MIN(_capacity - size(), _capacity - idx));
+    }
+
+    void commit(size_t n) requires std::is_trivially_copyable_v<T> {
+        _writePos += INK_MIN(n, _capacity - size());
+    }
+
+    void clear() {
+        consume(size());
+        _readPos = 0;
+        _writePos = 0;
+    }
+
+    size_t size() const { return static_cast<size_t>(_writePos - _readPos); }
+    size_t capacity() const { return _capacity; }
+    bool empty() const { return _writePos == _readPos; }
+    bool full() const { return size() == _capacity; }
+
+    // Records dropped by OverwriteOldest since construction
+    u64 overwritten() const { return _overwritten; }
+
+private:
+    T* slot(u64 pos) const { return _slots + static_cast<size_t>(pos & _mask); }
+
+    void release() noexcept {
+        if (!_slots) return;
+        consume(size());
+        ::operator delete(_slots, std::align_val_t(alignof(T)));
+        _slots = nullptr;
+    }
+
+    T* _slots;
+    size_t _capacity;
+    size_t _mask;
+    u64 _readPos;
+    u64 _writePos;
+    u64 _overwritten;
+    Policy _policy;
+};
+
+} // namespace ink
+
+#endif // TYPEDRINGBUFFER_H
@@ -8,6 +8,7 @@
 #include <condition_variable>
 
 #include "ink/ink_base.hpp"
+#include "ink/CachePadded.h"
 
 namespace ink {
 
@@ -33,8 +34,8 @@ public:
     void setOnStartAction(WTCallback onStartCallback) noexcept;
     void setOnDestructionAction(WTCallback onDestructionCallback) noexcept;
 
-    bool isRunning() const { return _isRunning; }
-    bool isProcessing() const { return _isProcessing; }
+    bool isRunning() const { return *_isRunning; }
+    bool isProcessing() const { return *_isProcessing; }
 
 protected:
     virtual void process() = 0;
@@ -42,8 +43,11 @@ protected:
 private:
     void _process();
 
-    std::atomic<bool> _isRunning;
-    std::atomic<bool> _isProcessing;
+    // The worker polls _isRunning every loop and flips _isProcessing around
+    // every process() call while other threads take _mutex to wake it, so
+    // each flag gets its own line
+    CachePadded<std::atomic<bool>> _isRunning;
+    CachePadded<std::atomic<bool>> _isProcessing;
     bool _requestProcessing;
 
     Policy _policy;
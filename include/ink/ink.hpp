@@ -9,6 +9,10 @@
 #include <ink/AlignedAllocator.h>
 #include <ink/ArenaAllocator.h>
 #include <ink/ArgParser.h>
+#include <ink/BroadcastRing.h>
+#include <ink/CachePadded.h>
+#include <ink/ConcurrentArena.h>
+#include <ink/ConcurrentObjectPool.h>
 #include <ink/EnhancedJson.h>
 #include <ink/EnhancedJsonUtils.h>
 #include <ink/Inkogger.h>
@@ -19,9 +23,14 @@
 #include <ink/InkedList.h>
 #include <ink/LastWish.h>
 #include <ink/ObjectPool.h>
+#include <ink/PageAllocator.h>
+#include <ink/PoolPtr.h>
 #include <ink/Queue.h>
 #include <ink/RingBuffer.h>
+#include <ink/SlotMap.h>
+#include <ink/SpscRingBuffer.h>
 #include <ink/TimerWheel.h>
+#include <ink/TypedRingBuffer.h>
 #include <ink/ThreadPool.h>
 #include <ink/WorkerThread.h>
 #include <ink/utils.h>
@@ -1,8 +1,7 @@
 #include "ink/ArenaAllocator.h"
 
-// mmap/munmap have no Windows equivalent; arena_new_block/arena_destroy
-// below reserve+commit anonymous pages via VirtualAlloc/VirtualFree
-// instead.
+// Regular blocks come from PageAllocator. Reserve mode manages its own
+// mapping below: mmap/mprotect, or VirtualAlloc reserve+commit on Windows.
 #if defined(INK_PLATFORM_WINDOWS)
 #ifndef WIN32_LEAN_AND_MEAN
 #define WIN32_LEAN_AND_MEAN
@@ -13,66 +12,198 @@
 #include <windows.h>
 #else
 #include <sys/mman.h>
+#include <unistd.h>
 
 #ifndef MAP_ANONYMOUS
 #define MAP_ANONYMOUS MAP_ANON
 #endif
 
-#ifndef MAP_POPULATE
-#define MAP_POPULATE 0
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
 #endif
 #endif
 
 namespace ink {
 
-InkedArena::ArenaBlock* InkedArena::arena_new_block(size_t size)
+// Touches one byte per page so the kernel backs the range now rather than
+// on first use
+static void arena_prefault(u8* begin, size_t len)
 {
-    const size_t total = sizeof(ArenaBlock) + size;
+    const size_t page = PageAllocator::pageSize();
+    for (size_t i = 0; i < len; i += page)
+    {
+        reinterpret_cast<volatile u8*>(begin)[i] = 0;
+    }
+}
 
-#if defined(INK_PLATFORM_WINDOWS)
-    // MEM_COMMIT forces immediate physical backing, mirroring MAP_POPULATE
-    // below so first access doesn't take a page fault.
-    void* raw_mem = VirtualAlloc(nullptr, total, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
-    if (raw_mem == nullptr) 
-        return nullptr;
-#else
-    // Added MAP_POPULATE to force physical memory allocation immediately.
-    // This prevents "Page Faults" when you first access the memory.
-    void* raw_mem = mmap(
-        NULL,
-        total,
-        PROT_READ | PROT_WRITE,
-        MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE,
-        -1, 0
-        );
-
-    if (raw_mem == MAP_FAILED) 
+static PageAllocator::HugePages arena_huge_policy(u32 flags)
+{
+    if (INK_FLAG_CHECK(flags, InkedArena::HugePagesExplicit)) return PageAllocator::Explicit;
+    if (INK_FLAG_CHECK(flags, InkedArena::HugePages)) return PageAllocator::Transparent;
+    return PageAllocator::None;
+}
+
+InkedArena::ArenaBlock* InkedArena::arena_new_block(size_t size, u32 flags)
+{
+    // Pages are backed on first touch unless Prefault asks for
+    // MAP_POPULATE, which trades a zeroing stall now for no page faults
+    // later. Huge-page blocks are rounded up to 2 MB and the slack is
+    // handed to the block rather than wasted.
+    const PageAllocator::Grant grant = PageAllocator::map(
+        sizeof(ArenaBlock) + size, arena_huge_policy(flags), INK_FLAG_CHECK(flags, Prefault));
+    if (!grant.memory)
         return nullptr;
-#endif
 
-    ArenaBlock* block = static_cast<ArenaBlock*>(raw_mem);
+    ArenaBlock* block = static_cast<ArenaBlock*>(grant.memory);
 
     // (block + 1) moves the pointer by sizeof(ArenaBlock) bytes
     block->memory = reinterpret_cast<u8*>(block + 1);
-    block->size = size;
+    block->size = grant.bytes - sizeof(ArenaBlock);
     block->offset = 0;
     block->next = nullptr;
+    block->reserved = 0;
+    block->granted = grant.granted;
 
     return block;
 }
 
-void InkedArena::arena_init(Arena* a, size_t block_size)
+void InkedArena::arena_init(Arena* a, size_t block_size, u32 flags)
 {
     a->block_size = block_size;
-    a->head = arena_new_block(block_size);
+    a->head = arena_new_block(block_size, flags);
+    a->spare = nullptr;
+    a->retain_bytes = 0;
+    a->flags = flags;
+    a->finalizers = nullptr;
+    a->requested = 0;
+    a->peak = 0;
+    a->source = ArenaBlockSource{};
+}
+
+void InkedArena::arena_init_reserve(Arena* a, size_t reserve_bytes, size_t commit_step, u32 flags)
+{
+    const size_t page = PageAllocator::pageSize();
+    const size_t total = INK_ALIGN_SIZE(sizeof(ArenaBlock) + reserve_bytes, page);
+
+    a->block_size = INK_ALIGN_SIZE(INK_MAX(commit_step, size_t(1)), page);
+    a->head = nullptr;
+    a->spare = nullptr;
+    a->retain_bytes = 0;
+    a->flags = flags;
+    a->finalizers = nullptr;
+    a->requested = 0;
+    a->peak = 0;
+    a->source = ArenaBlockSource{};
+
+#if defined(INK_PLATFORM_WINDOWS)
+    void* raw_mem = VirtualAlloc(nullptr, total, MEM_RESERVE, PAGE_NOACCESS);
+    if (raw_mem == nullptr)
+        return;
+
+    // The header page has to be writable before the block can describe
+    // itself
+    if (!VirtualAlloc(raw_mem, page, MEM_COMMIT, PAGE_READWRITE))
+    {
+        VirtualFree(raw_mem, 0, MEM_RELEASE);
+        return;
+    }
+#else
+    void* raw_mem = mmap(NULL, total, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (raw_mem == MAP_FAILED)
+        return;
+
+    if (mprotect(raw_mem, page, PROT_READ | PROT_WRITE) != 0)
+    {
+        munmap(raw_mem, total);
+        return;
+    }
+#endif
+
+    ArenaBlock* block = static_cast<ArenaBlock*>(raw_mem);
+    block->memory = reinterpret_cast<u8*>(block + 1);
+    block->size = page - sizeof(ArenaBlock);
+    block->offset = 0;
+    block->next = nullptr;
+    block->reserved = total - sizeof(ArenaBlock);
+    block->granted = PageAllocator::Small;
+
+#if defined(MADV_HUGEPAGE)
+    // Commits then fault in huge pages wherever a 2 MB extent lines up
+    if (arena_huge_policy(flags) != PageAllocator::None && madvise(raw_mem, total, MADV_HUGEPAGE) == 0)
+        block->granted = PageAllocator::Advised;
+#endif
+
+    a->head = block;
+    // One step from the start of the mapping, header included
+    arena_commit(a, block, a->block_size - sizeof(ArenaBlock));
+}
+
+bool InkedArena::arena_commit(Arena* a, ArenaBlock* b, size_t needed)
+{
+    if (needed > b->reserved) return false;
+    if (needed <= b->size) return true;
+
+    // Commit whole steps measured from the start of the mapping so the range
+    // stays page aligned. block_size is page-rounded in reserve mode but not
+    // necessarily a power of two, so this is a division, not a mask
+    const size_t begin = sizeof(ArenaBlock) + b->size;
+    const size_t step = a->block_size;
+    size_t end = ((sizeof(ArenaBlock) + needed + step - 1) / step) * step;
+    end = INK_MIN(end, sizeof(ArenaBlock) + b->reserved);
+
+    u8* base = reinterpret_cast<u8*>(b);
+#if defined(INK_PLATFORM_WINDOWS)
+    if (!VirtualAlloc(base + begin, end - begin, MEM_COMMIT, PAGE_READWRITE))
+        return false;
+#else
+    if (mprotect(base + begin, end - begin, PROT_READ | PROT_WRITE) != 0)
+        return false;
+#endif
+
+    if (INK_FLAG_CHECK(a->flags, Prefault))
+        arena_prefault(base + begin, end - begin);
+
+    b->size = end - sizeof(ArenaBlock);
+    return true;
 }
 
 void* InkedArena::arena_alloc_hard(Arena* a, size_t size, size_t align)
 {
-    size_t new_size = (size > a->block_size) ? (size + align) : a->block_size;
+    // Reserve mode: grow the head in place while the reservation lasts
+    ArenaBlock* head = a->head;
+    if (head && head->reserved)
+    {
+        const u64 base = reinterpret_cast<u64>(head->memory);
+        const size_t start = static_cast<size_t>(INK_ALIGN_SIZE(base + head->offset, align) - base);
+        if (arena_commit(a, head, start + size))
+            return arena_alloc_block(head, size, align);
+    }
 
-    ArenaBlock* new_block = arena_new_block(new_size);
-    if (!new_block) return nullptr;
+    // First fit from the spare list; size + align covers any padding
+    ArenaBlock* new_block = nullptr;
+    for (ArenaBlock** link = &a->spare; *link; link = &(*link)->next)
+    {
+        if ((*link)->size >= size + align)
+        {
+            new_block = *link;
+            *link = new_block->next;
+            break;
+        }
+    }
+
+    if (!new_block)
+    {
+        if (a->source.acquire)
+        {
+            new_block = a->source.acquire(a->source.ctx, size + align);
+        }
+        else
+        {
+            size_t new_size = (size > a->block_size) ? (size + align) : a->block_size;
+            new_block = arena_new_block(new_size, a->flags);
+        }
+        if (!new_block) return nullptr;
+    }
 
     // Link new block as the new head (LIFO structure)
     new_block->next = a->head;
@@ -81,28 +212,226 @@ void* InkedArena::arena_alloc_hard(Arena* a, size_t size, size_t align)
     return arena_alloc_block(new_block, size, align);
 }
 
-void InkedArena::arena_reset(Arena* a)
+void InkedArena::arena_give_back(Arena* a, ArenaBlock* chain)
 {
-    for (ArenaBlock* b = a->head; b; b = b->next)
+    if (!chain) return;
+
+    if (a->source.release)
+    {
+        a->source.release(a->source.ctx, chain);
+        return;
+    }
+
+    ArenaBlock* tail = chain;
+    for (ArenaBlock* b = chain; b; b = b->next)
     {
         b->offset = 0;
+        tail = b;
     }
+    tail->next = a->spare;
+    a->spare = chain;
 }
 
-void InkedArena::arena_destroy(Arena* a)
+void InkedArena::arena_run_finalizers(Arena* a, ArenaFinalizer* stop)
+{
+    // Unlink before calling so a destructor that allocates or finalizes
+    // from the same arena sees a consistent list
+    while (a->finalizers && a->finalizers != stop)
+    {
+        ArenaFinalizer* fin = a->finalizers;
+        a->finalizers = fin->next;
+        fin->destroy(fin->objects, fin->count);
+    }
+}
+
+static size_t arena_used(const InkedArena::Arena* a)
+{
+    size_t used = 0;
+    for (InkedArena::ArenaBlock* b = a->head; b; b = b->next) used += b->offset;
+    return used;
+}
+
+static void arena_note_peak(InkedArena::Arena* a)
+{
+    a->peak = INK_MAX(a->peak, arena_used(a));
+}
+
+#if INK_ALLOCATOR_DEBUG
+// Freed bytes are poisoned so stale pointers read garbage, not old data
+static void arena_poison(InkedArena::ArenaBlock* b, size_t from)
+{
+    if (b->offset > from) memset(b->memory + from, AllocatorDebug::kPoison, b->offset - from);
+}
+#endif
+
+void InkedArena::arena_reset(Arena* a)
+{
+    arena_run_finalizers(a);
+    arena_note_peak(a);
+    a->requested = 0;
+#if INK_ALLOCATOR_DEBUG
+    for (ArenaBlock* b = a->head; b; b = b->next) arena_poison(b, 0);
+#endif
+
+    // The tail is the oldest block (usually the block_size one from
+    // arena_init); everything in front of it becomes spare, or goes back
+    // to the block source in one call
+    ArenaBlock* freed = nullptr;
+    while (a->head && a->head->next)
+    {
+        ArenaBlock* next = a->head->next;
+        a->head->next = freed;
+        freed = a->head;
+        a->head = next;
+    }
+    arena_give_back(a, freed);
+
+    if (a->head)
+    {
+        a->head->offset = 0;
+    }
+
+    if (a->retain_bytes)
+    {
+        arena_trim(a, a->retain_bytes);
+    }
+}
+
+void InkedArena::arena_trim(Arena* a, size_t keep_bytes)
+{
+    size_t mapped = 0;
+    for (ArenaBlock* b = a->head; b; b = b->next) mapped += b->size;
+    for (ArenaBlock* b = a->spare; b; b = b->next) mapped += b->size;
+
+    while (a->spare && mapped > keep_bytes)
+    {
+        ArenaBlock* b = a->spare;
+        a->spare = b->next;
+        mapped -= b->size;
+        arena_free_block(b);
+    }
+
+    // Decommit the untouched tail of reserve-mode blocks; the address
+    // range stays reserved for the next commit
+    const size_t page = PageAllocator::pageSize();
+    for (ArenaBlock* b = a->head; b && mapped > keep_bytes; b = b->next)
+    {
+        if (!b->reserved) continue;
+
+        const size_t excess = mapped - keep_bytes;
+        const size_t target = (b->size > excess) ? b->size - excess : 0;
+
+        // Round the budget down to a page, but never below the live bytes
+        const size_t floor = (sizeof(ArenaBlock) + target) & ~(page - 1);
+        const size_t live = INK_ALIGN_SIZE(sizeof(ArenaBlock) + b->offset, page);
+        const size_t begin = INK_MAX(floor, live);
+        const size_t end = sizeof(ArenaBlock) + b->size;
+        if (begin >= end) continue;
+
+        u8* base = reinterpret_cast<u8*>(b);
+#if defined(INK_PLATFORM_WINDOWS)
+        VirtualFree(base + begin, end - begin, MEM_DECOMMIT);
+#else
+        madvise(base + begin, end - begin, MADV_DONTNEED);
+        mprotect(base + begin, end - begin, PROT_NONE);
+#endif
+        mapped -= end - begin;
+        b->size = begin - sizeof(ArenaBlock);
+    }
+}
+
+void InkedArena::arena_free_block(ArenaBlock* b)
 {
-    ArenaBlock* b = a->head;
-    while (b)
+    if (b->reserved)
     {
-        ArenaBlock* next = b->next;
 #if defined(INK_PLATFORM_WINDOWS)
         VirtualFree(b, 0, MEM_RELEASE);
 #else
-        munmap(b, sizeof(ArenaBlock) + b->size);
+        munmap(b, sizeof(ArenaBlock) + b->reserved);
 #endif
-        b = next;
+        return;
+    }
+
+    PageAllocator::unmap(PageAllocator::Grant{ b, sizeof(ArenaBlock) + b->size,
+                                               static_cast<PageAllocator::Granted>(b->granted) });
+}
+
+void InkedArena::arena_destroy(Arena* a)
+{
+    arena_run_finalizers(a);
+
+    if (a->source.release)
+    {
+        arena_give_back(a, a->head);
+        a->head = nullptr;
+    }
+
+    for (ArenaBlock* list : { a->head, a->spare })
+    {
+        ArenaBlock* b = list;
+        while (b)
+        {
+            ArenaBlock* next = b->next;
+            arena_free_block(b);
+            b = next;
+        }
     }
     a->head = nullptr;
+    a->spare = nullptr;
+}
+
+void InkedArena::arena_rewind(Arena* a, ArenaMark mark)
+{
+    arena_run_finalizers(a, mark.finalizers);
+    arena_note_peak(a);
+    a->requested = mark.requested;
+#if INK_ALLOCATOR_DEBUG
+    for (ArenaBlock* b = a->head; b; b = b->next)
+    {
+        arena_poison(b, b == mark.block ? mark.offset : 0);
+        if (b == mark.block) break;
+    }
+#endif
+
+    // Blocks are LIFO, so everything in front of the marked block was
+    // created after the mark
+    ArenaBlock* freed = nullptr;
+    while (a->head && a->head != mark.block)
+    {
+        ArenaBlock* next = a->head->next;
+        a->head->next = freed;
+        freed = a->head;
+        a->head = next;
+    }
+    arena_give_back(a, freed);
+
+    if (a->head)
+    {
+        a->head->offset = mark.offset;
+    }
+}
+
+InkedArena::ArenaStats InkedArena::arena_stats(Arena* a)
+{
+    arena_note_peak(a);
+
+    ArenaStats stats{};
+    stats.requested = a->requested;
+    stats.peak = a->peak;
+    for (ArenaBlock* b = a->head; b; b = b->next)
+    {
+        stats.used += b->offset;
+        stats.committed += b->size;
+        stats.reserved += b->reserved ? b->reserved : b->size;
+        ++stats.blocks;
+    }
+    for (ArenaBlock* b = a->spare; b; b = b->next)
+    {
+        stats.committed += b->size;
+        stats.reserved += b->reserved ? b->reserved : b->size;
+        ++stats.spare_blocks;
+    }
+    return stats;
 }
 
 }
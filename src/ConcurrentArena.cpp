@@ -0,0 +1,241 @@
+#include "../include/ink/ConcurrentArena.h"
+
+namespace ink {
+
+/*====================
+ * BlockRecycler
+ *====================*/
+
+BlockRecycler::BlockRecycler(size_t blockSize, u32 flags) :
+    _free(nullptr),
+    _pooledBytes(0),
+    _blockSize(blockSize),
+    _flags(flags)
+{
+    // Empty
+}
+
+BlockRecycler::~BlockRecycler()
+{
+    trim(0);
+}
+
+InkedArena::ArenaBlock* BlockRecycler::acquire(size_t minBytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (InkedArena::ArenaBlock** link = &_free; *link; link = &(*link)->next)
+        {
+            InkedArena::ArenaBlock* b = *link;
+            if (b->size >= minBytes)
+            {
+                *link = b->next;
+                _pooledBytes -= b->size;
+                b->next = nullptr;
+                return b;
+            }
+        }
+    }
+
+    return InkedArena::arena_new_block(INK_MAX(minBytes, _blockSize), _flags);
+}
+
+void BlockRecycler::release(InkedArena::ArenaBlock* chain)
+{
+    if (!chain) return;
+
+    // Reset and measure outside the lock, then splice the chain in whole
+    size_t bytes = 0;
+    InkedArena::ArenaBlock* tail = chain;
+    for (InkedArena::ArenaBlock* b = chain; b; b = b->next)
+    {
+        b->offset = 0;
+        bytes += b->size;
+        tail = b;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    tail->next = _free;
+    _free = chain;
+    _pooledBytes += bytes;
+}
+
+void BlockRecycler::trim(size_t keepBytes)
+{
+    InkedArena::ArenaBlock* victims = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        while (_free && _pooledBytes > keepBytes)
+        {
+            InkedArena::ArenaBlock* b = _free;
+            _free = b->next;
+            _pooledBytes -= b->size;
+            b->next = victims;
+            victims = b;
+        }
+    }
+
+    while (victims)
+    {
+        InkedArena::ArenaBlock* next = victims->next;
+        InkedArena::arena_free_block(victims);
+        victims = next;
+    }
+}
+
+size_t BlockRecycler::pooledBytes() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _pooledBytes;
+}
+
+InkedArena::ArenaBlock* BlockRecycler::acquireThunk(void* self, size_t minBytes)
+{
+    return static_cast<BlockRecycler*>(self)->acquire(minBytes);
+}
+
+void BlockRecycler::releaseThunk(void* self, InkedArena::ArenaBlock* chain)
+{
+    static_cast<BlockRecycler*>(self)->release(chain);
+}
+
+BlockRecycler& BlockRecycler::global()
+{
+    static BlockRecycler recycler;
+    return recycler;
+}
+
+/*====================
+ * ThreadArena
+ *====================*/
+
+namespace {
+
+struct ThreadArenaHolder {
+    InkedArena::Arena arena{};
+    BlockRecycler* recycler = &BlockRecycler::global();
+
+    ThreadArenaHolder()
+    {
+        arena.block_size = recycler->blockSize();
+        arena.source = recycler->source();
+    }
+
+    ~ThreadArenaHolder()
+    {
+        // Runs finalizers, then hands every block to the recycler
+        InkedArena::arena_destroy(&arena);
+    }
+};
+
+ThreadArenaHolder& threadArenaHolder()
+{
+    thread_local ThreadArenaHolder holder;
+    return holder;
+}
+
+}
+
+InkedArena::Arena* ThreadArena::local()
+{
+    return &threadArenaHolder().arena;
+}
+
+void ThreadArena::reset()
+{
+    InkedArena::arena_reset(local());
+}
+
+/*====================
+ * ConcurrentArena
+ *====================*/
+
+ConcurrentArena::ConcurrentArena(size_t blockSize, u32 flags) :
+    _recycler(blockSize, flags),
+    _head(nullptr)
+{
+    // Empty
+}
+
+ConcurrentArena::~ConcurrentArena()
+{
+    _recycler.release(_head.load(std::memory_order_acquire));
+}
+
+void* ConcurrentArena::alloc(size_t size, size_t align)
+{
+    for (;;)
+    {
+        InkedArena::ArenaBlock* b = _head.load(std::memory_order_acquire);
+        if (b)
+        {
+            std::atomic_ref<size_t> offset(b->offset);
+            const u64 base = reinterpret_cast<u64>(b->memory);
+            size_t current = offset.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                const u64 dest = INK_ALIGN_SIZE(base + current, align);
+                const size_t end = static_cast<size_t>(dest - base) + size;
+                if (end > b->size) break;
+
+                if (offset.compare_exchange_weak(current, end, std::memory_order_relaxed))
+                    return reinterpret_cast<void*>(dest);
+            }
+        }
+
+        void* mem = grow(b, size, align);
+        if (mem) return mem;
+        if (_head.load(std::memory_order_acquire) == b) return nullptr; // mapping failed
+    }
+}
+
+void* ConcurrentArena::grow(InkedArena::ArenaBlock* seen, size_t size, size_t align)
+{
+    std::lock_guard<std::mutex> lock(_growMutex);
+
+    // Another thread already chained a block on; retry the fast path
+    if (_head.load(std::memory_order_relaxed) != seen) return nullptr;
+
+    InkedArena::ArenaBlock* b = _recycler.acquire(size + align);
+    if (!b) return nullptr;
+
+    // Carve our allocation before publishing so it can't be lost to a race
+    void* mem = InkedArena::arena_alloc_block(b, size, align);
+    b->next = seen;
+    _head.store(b, std::memory_order_release);
+    return mem;
+}
+
+void ConcurrentArena::reset()
+{
+    std::lock_guard<std::mutex> lock(_growMutex);
+
+    InkedArena::ArenaBlock* b = _head.load(std::memory_order_relaxed);
+    if (!b) return;
+
+    // Keep the oldest block, as InkedArena::arena_reset does
+    InkedArena::ArenaBlock* oldest = b;
+    InkedArena::ArenaBlock* newer = nullptr;
+    while (oldest->next)
+    {
+        InkedArena::ArenaBlock* next = oldest->next;
+        oldest->next = newer;
+        newer = oldest;
+        oldest = next;
+    }
+    // newer now holds the rest in reverse; order doesn't matter to the pool
+    _recycler.release(newer);
+
+    oldest->offset = 0;
+    _head.store(oldest, std::memory_order_release);
+}
+
+size_t ConcurrentArena::blockCount() const
+{
+    std::lock_guard<std::mutex> lock(_growMutex);
+    size_t n = 0;
+    for (InkedArena::ArenaBlock* b = _head.load(std::memory_order_acquire); b; b = b->next) ++n;
+    return n;
+}
+
+}
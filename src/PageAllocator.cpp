@@ -0,0 +1,284 @@
+#include "../include/ink/PageAllocator.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(INK_PLATFORM_WINDOWS)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+#ifndef MAP_POPULATE
+#define MAP_POPULATE 0
+#endif
+#endif
+
+namespace ink {
+
+namespace {
+
+std::atomic<u64> g_smallBytes{0};
+std::atomic<u64> g_advisedBytes{0};
+std::atomic<u64> g_hugeBytes{0};
+std::atomic<u64> g_explicitFallbacks{0};
+std::atomic<u64> g_numaFallbacks{0};
+
+std::atomic<u64>& counterFor(PageAllocator::Granted granted)
+{
+    switch (granted)
+    {
+    case PageAllocator::Huge: return g_hugeBytes;
+    case PageAllocator::Advised: return g_advisedBytes;
+    default: return g_smallBytes;
+    }
+}
+
+void prefault(void* memory, size_t bytes)
+{
+    const size_t page = PageAllocator::pageSize();
+    for (size_t i = 0; i < bytes; i += page)
+    {
+        static_cast<volatile u8*>(memory)[i] = 0;
+    }
+}
+
+#if !defined(INK_PLATFORM_WINDOWS)
+void* mapAnonymous(size_t bytes, int extraFlags)
+{
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | extraFlags, -1, 0);
+    return p == MAP_FAILED ? nullptr : p;
+}
+
+// Over-maps by one huge page and trims both ends so the range starts on a
+// 2 MB boundary, which THP needs to use a huge page for the first extent
+void* mapHugeAligned(size_t bytes)
+{
+    const size_t huge = PageAllocator::kHugePageSize;
+    u8* raw = static_cast<u8*>(mapAnonymous(bytes + huge, 0));
+    if (!raw) return nullptr;
+
+    const uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+    u8* aligned = reinterpret_cast<u8*>(INK_ALIGN_SIZE(start, huge));
+    const size_t head = static_cast<size_t>(aligned - raw);
+    const size_t tail = huge - head;
+
+    if (head) munmap(raw, head);
+    if (tail) munmap(aligned + bytes, tail);
+    return aligned;
+}
+
+// MPOL_PREFERRED for the whole range; must run before the pages are
+// faulted in, since a policy only steers future allocations
+bool bindToNode(void* memory, size_t bytes, int node)
+{
+#if defined(__linux__) && defined(SYS_mbind)
+    constexpr int kMpolPreferred = 1;
+    constexpr size_t kMaskBits = 1024;
+    constexpr size_t kLongBits = sizeof(unsigned long) * 8;
+    if (node < 0 || static_cast<size_t>(node) >= kMaskBits) return false;
+
+    unsigned long mask[kMaskBits / kLongBits] = {};
+    mask[node / kLongBits] = 1UL << (node % kLongBits);
+    // The kernel reads maxnode - 1 bits
+    return syscall(SYS_mbind, memory, bytes, kMpolPreferred, mask, kMaskBits + 1, 0) == 0;
+#else
+    INK_UNUSED(memory);
+    INK_UNUSED(bytes);
+    INK_UNUSED(node);
+    return false;
+#endif
+}
+#endif
+
+}
+
+size_t PageAllocator::pageSize()
+{
+#if defined(INK_PLATFORM_WINDOWS)
+    static const size_t page = [] {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return static_cast<size_t>(info.dwPageSize);
+    }();
+#else
+    static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    return page;
+}
+
+size_t PageAllocator::roundUp(size_t bytes, HugePages policy)
+{
+    const size_t unit = (policy == None) ? pageSize() : kHugePageSize;
+    return INK_ALIGN_SIZE(INK_MAX(bytes, size_t(1)), unit);
+}
+
+PageAllocator::Grant PageAllocator::map(size_t bytes, HugePages policy, bool populate, int node)
+{
+    Grant grant{ nullptr, roundUp(bytes, policy), Small };
+
+#if defined(INK_PLATFORM_WINDOWS)
+    // Large pages need SeLockMemoryPrivilege; regular pages are the
+    // portable answer
+    if (node != kNoNode)
+    {
+        grant.memory = VirtualAllocExNuma(GetCurrentProcess(), nullptr, grant.bytes, MEM_COMMIT | MEM_RESERVE,
+                                          PAGE_READWRITE, static_cast<DWORD>(node));
+        if (!grant.memory) g_numaFallbacks.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (!grant.memory)
+        grant.memory = VirtualAlloc(nullptr, grant.bytes, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (policy == Explicit) g_explicitFallbacks.fetch_add(1, std::memory_order_relaxed);
+    if (grant.memory && populate) prefault(grant.memory, grant.bytes);
+#else
+    // With a node, pages are only touched after binding
+    const bool eager = populate && node == kNoNode;
+
+#if defined(MAP_HUGETLB)
+    if (policy == Explicit)
+    {
+        grant.memory = mapAnonymous(grant.bytes, MAP_HUGETLB | (eager ? MAP_POPULATE : 0));
+        if (grant.memory)
+        {
+            grant.granted = Huge;
+        }
+        else
+        {
+            g_explicitFallbacks.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+#else
+    if (policy == Explicit) g_explicitFallbacks.fetch_add(1, std::memory_order_relaxed);
+#endif
+
+    if (!grant.memory && policy != None)
+    {
+        grant.memory = mapHugeAligned(grant.bytes);
+#if defined(MADV_HUGEPAGE)
+        if (grant.memory && madvise(grant.memory, grant.bytes, MADV_HUGEPAGE) == 0)
+            grant.granted = Advised;
+#endif
+        // Touch after advising so the faults can take huge pages
+        if (grant.memory && eager) prefault(grant.memory, grant.bytes);
+    }
+
+    if (!grant.memory && policy == None)
+    {
+        grant.memory = mapAnonymous(grant.bytes, eager ? MAP_POPULATE : 0);
+    }
+
+    if (grant.memory && node != kNoNode)
+    {
+        if (!bindToNode(grant.memory, grant.bytes, node))
+            g_numaFallbacks.fetch_add(1, std::memory_order_relaxed);
+        if (populate) prefault(grant.memory, grant.bytes);
+    }
+#endif
+
+    if (grant.memory)
+    {
+        counterFor(grant.granted).fetch_add(grant.bytes, std::memory_order_relaxed);
+    }
+    return grant;
+}
+
+void PageAllocator::unmap(const Grant& grant)
+{
+    if (!grant.memory) return;
+
+#if defined(INK_PLATFORM_WINDOWS)
+    VirtualFree(grant.memory, 0, MEM_RELEASE);
+#else
+    munmap(grant.memory, grant.bytes);
+#endif
+    counterFor(grant.granted).fetch_sub(grant.bytes, std::memory_order_relaxed);
+}
+
+PageAllocator::Stats PageAllocator::stats()
+{
+    return Stats{
+        g_smallBytes.load(std::memory_order_relaxed),
+        g_advisedBytes.load(std::memory_order_relaxed),
+        g_hugeBytes.load(std::memory_order_relaxed),
+        g_explicitFallbacks.load(std::memory_order_relaxed),
+        g_numaFallbacks.load(std::memory_order_relaxed)
+    };
+}
+
+int PageAllocator::numaNodeCount()
+{
+    static const int count = [] {
+#if defined(INK_PLATFORM_WINDOWS)
+        ULONG highest = 0;
+        return GetNumaHighestNodeNumber(&highest) ? static_cast<int>(highest) + 1 : 1;
+#elif defined(__linux__)
+        // Node ids need not be contiguous ("0,2"), so the count is the
+        // highest possible id + 1
+        int highest = 0;
+        if (FILE* f = std::fopen("/sys/devices/system/node/possible", "r"))
+        {
+            char list[256] = {};
+            if (std::fgets(list, sizeof(list), f)) highest = INK_MAX(highestInList(list), 0);
+            std::fclose(f);
+        }
+        return highest + 1;
+#else
+        return 1;
+#endif
+    }();
+    return count;
+}
+
+int PageAllocator::highestInList(const char* list)
+{
+    // Ranges and singles separated by commas; every range is ascending, so
+    // the highest id is simply the largest number anywhere in the string
+    int highest = -1;
+    const char* p = list;
+    while (*p)
+    {
+        if (*p < '0' || *p > '9')
+        {
+            ++p;
+            continue;
+        }
+        char* end = nullptr;
+        const long id = std::strtol(p, &end, 10);
+        highest = INK_MAX(highest, static_cast<int>(id));
+        p = end;
+    }
+    return highest;
+}
+
+int PageAllocator::currentNumaNode()
+{
+#if defined(INK_PLATFORM_WINDOWS)
+    PROCESSOR_NUMBER processor;
+    GetCurrentProcessorNumberEx(&processor);
+    USHORT node = 0;
+    return GetNumaProcessorNodeEx(&processor, &node) ? static_cast<int>(node) : 0;
+#elif defined(__linux__) && defined(SYS_getcpu)
+    unsigned cpu = 0;
+    unsigned node = 0;
+    return syscall(SYS_getcpu, &cpu, &node, nullptr) == 0 ? static_cast<int>(node) : 0;
+#else
+    return 0;
+#endif
+}
+
+}
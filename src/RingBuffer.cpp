@@ -1,63 +1,373 @@
 #include "../include/ink/RingBuffer.h"
+#include "../include/ink/CachePadded.h"
+
+#include <bit>
+#include <cerrno>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define INK_RINGBUFFER_HAS_SSE2 1
+#endif
+
+#if !defined(INK_PLATFORM_WINDOWS)
+#include <sys/uio.h>
+#endif
+
+// The mirrored layout needs an fd-backed mapping that can be mapped twice;
+// memfd_create is Linux-only, other platforms fall back to the flat buffer.
+#if defined(INK_PLATFORM_LINUX)
+#include <sys/mman.h>
+#include <unistd.h>
+#define INK_RINGBUFFER_HAS_MIRROR 1
+#endif
 
 namespace ink {
 
-RingBuffer::RingBuffer(size_t capacity) :
-    _buffer(capacity),
-    _capacity(capacity),
+namespace {
+
+// First full occurrence of needle (size >= 1) inside [hay, hay + n), or
+// nullptr. Single bytes go through memchr (vectorized by the C library);
+// longer needles use a 16-byte first/last-byte filter and only memcmp the
+// middle of candidate positions.
+const char* searchSegment(const char* hay, size_t n, std::string_view needle)
+{
+    const size_t m = needle.size();
+    if (n < m)
+        return nullptr;
+
+    if (m == 1)
+        return static_cast<const char*>(memchr(hay, needle[0], n));
+
+    size_t i = 0;
+
+#if defined(INK_RINGBUFFER_HAS_SSE2)
+    const __m128i firstByte = _mm_set1_epi8(needle[0]);
+    const __m128i lastByte = _mm_set1_epi8(needle[m - 1]);
+
+    for (; i + m - 1 + 16 <= n; i += 16)
+    {
+        const __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hay + i));
+        const __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hay + i + m - 1));
+        u32 mask = static_cast<u32>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(blockFirst, firstByte), _mm_cmpeq_epi8(blockLast, lastByte))));
+
+        while (mask)
+        {
+            const size_t pos = i + static_cast<size_t>(std::countr_zero(mask));
+            if (memcmp(hay + pos + 1, needle.data() + 1, m - 2) == 0)
+                return hay + pos;
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    // Scalar tail (or whole segment without SSE2): memchr to the next
+    // candidate first byte, then verify
+    while (i + m <= n)
+    {
+        const char* candidate = static_cast<const char*>(memchr(hay + i, needle[0], n - m + 1 - i));
+        if (!candidate)
+            return nullptr;
+        if (memcmp(candidate + 1, needle.data() + 1, m - 1) == 0)
+            return candidate;
+        i = static_cast<size_t>(candidate - hay) + 1;
+    }
+    return nullptr;
+}
+
+#if defined(INK_RINGBUFFER_HAS_MIRROR)
+size_t pageRound(size_t len)
+{
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return INK_ALIGN_SIZE(len, page);
+}
+
+// Reserves 2 * len of address space, then maps the same memfd pages over
+// both halves. Returns nullptr on any failure.
+char* mapMirror(size_t len)
+{
+    const int fd = memfd_create("ink_ringbuffer", MFD_CLOEXEC);
+    if (fd < 0)
+        return nullptr;
+
+    char* base = nullptr;
+    if (ftruncate(fd, static_cast<off_t>(len)) == 0)
+    {
+        void* reserved = mmap(nullptr, len * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (reserved != MAP_FAILED)
+        {
+            base = static_cast<char*>(reserved);
+            void* lo = mmap(base, len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+            void* hi = mmap(base + len, len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+            if (lo == MAP_FAILED || hi == MAP_FAILED)
+            {
+                munmap(base, len * 2);
+                base = nullptr;
+            }
+        }
+    }
+
+    // The mappings keep the memfd alive
+    close(fd);
+    return base;
+}
+#endif
+
+}
+
+RingBuffer::RingBuffer(size_t capacity, u32 options) :
+    _mirror(nullptr),
+    _data(nullptr),
+    _capacity(0),
+    _mask(0),
     _readPos(0),
     _writePos(0),
-    _size(0)
+    _options(options),
+    _minCapacity(0),
+    _lowStreak(0),
+    _shrinkPending(false)
+{
+    allocate(capacity);
+    _minCapacity = _capacity;
+}
+
+RingBuffer::~RingBuffer()
+{
+    releaseMirror();
+}
+
+RingBuffer::RingBuffer(RingBuffer&& other) noexcept :
+    _buffer(std::move(other._buffer)),
+    _mirror(std::exchange(other._mirror, nullptr)),
+    _data(std::exchange(other._data, nullptr)),
+    _capacity(std::exchange(other._capacity, 0)),
+    _mask(std::exchange(other._mask, 0)),
+    _readPos(std::exchange(other._readPos, 0)),
+    _writePos(std::exchange(other._writePos, 0)),
+    _options(other._options),
+    _minCapacity(std::exchange(other._minCapacity, 0)),
+    _growth(std::exchange(other._growth, GrowthPolicy{})),
+    _lowStreak(std::exchange(other._lowStreak, 0)),
+    _shrinkPending(std::exchange(other._shrinkPending, false))
 {
     // Empty
 }
 
+RingBuffer& RingBuffer::operator=(RingBuffer&& other) noexcept
+{
+    if (this != &other)
+    {
+        releaseMirror();
+        _buffer = std::move(other._buffer);
+        _mirror = std::exchange(other._mirror, nullptr);
+        _data = std::exchange(other._data, nullptr);
+        _capacity = std::exchange(other._capacity, 0);
+        _mask = std::exchange(other._mask, 0);
+        _readPos = std::exchange(other._readPos, 0);
+        _writePos = std::exchange(other._writePos, 0);
+        _options = other._options;
+        _minCapacity = std::exchange(other._minCapacity, 0);
+        _growth = std::exchange(other._growth, GrowthPolicy{});
+        _lowStreak = std::exchange(other._lowStreak, 0);
+        _shrinkPending = std::exchange(other._shrinkPending, false);
+    }
+    return *this;
+}
+
+void RingBuffer::allocate(size_t capacity)
+{
+    _capacity = capacity;
+
+    if (INK_FLAG_CHECK(_options, PowerOfTwo))
+        _capacity = detail::roundPow2(_capacity);
+
+#if defined(INK_RINGBUFFER_HAS_MIRROR)
+    if (INK_FLAG_CHECK(_options, Mirrored) && _capacity > 0)
+    {
+        // Pages are powers of two, so rounding keeps PowerOfTwo intact
+        const size_t rounded = pageRound(_capacity);
+        _mirror = mapMirror(rounded);
+        if (_mirror)
+            _capacity = rounded;
+    }
+#endif
+
+    _mask = (_capacity > 0 && (_capacity & (_capacity - 1)) == 0) ? _capacity - 1 : 0;
+
+    if (!_mirror)
+        _buffer.resize(_capacity);
+
+    _data = _mirror ? _mirror : _buffer.data();
+}
+
+void RingBuffer::reallocate(size_t capacity)
+{
+    // Build the new storage off to the side: if it throws, this ring is
+    // untouched. Only then swap it in; fresh frees the old storage.
+    RingBuffer fresh(capacity, _options);
+    const size_t used = peek(0, size()).copyTo(fresh._data);
+
+    std::swap(_buffer, fresh._buffer);
+    std::swap(_mirror, fresh._mirror);
+    std::swap(_data, fresh._data);
+    std::swap(_capacity, fresh._capacity);
+    std::swap(_mask, fresh._mask);
+
+    _readPos = 0;
+    _writePos = used;
+}
+
+void RingBuffer::setGrowthPolicy(const GrowthPolicy& policy)
+{
+    _growth = policy;
+    _lowStreak = 0;
+    _shrinkPending = false;
+
+    // allocate() rounds requests up; round the cap down to the same grain
+    // once so no grown capacity can overshoot it
+    if (INK_FLAG_CHECK(_options, PowerOfTwo))
+        _growth.maxCapacity = std::bit_floor(_growth.maxCapacity);
+#if defined(INK_RINGBUFFER_HAS_MIRROR)
+    if (INK_FLAG_CHECK(_options, Mirrored))
+        _growth.maxCapacity -= _growth.maxCapacity % pageRound(1);
+#endif
+}
+
+bool RingBuffer::growFor(size_t len)
+{
+    const size_t used = size();
+    if (len <= _capacity - used)
+        return true;
+    if (_growth.maxCapacity <= _capacity)
+        return false;
+
+    // maxCapacity > _capacity >= used, so neither side can wrap
+    if (len > _growth.maxCapacity - used)
+        return false;
+    const size_t needed = used + len;
+
+    // Keep doubling so power-of-two rings stay on the masked path; every
+    // step is clamped to the cap, so the doubling cannot overflow
+    size_t target = std::max(_capacity, size_t(1));
+    do
+    {
+        target = (target >= _growth.maxCapacity - target) ? _growth.maxCapacity : target * 2;
+    } while (target < needed);
+
+    reallocate(target);
+    _lowStreak = 0;
+    _shrinkPending = false;
+    return true;
+}
+
+bool RingBuffer::reserve(size_t len)
+{
+    if (INK_UNLIKELY(_shrinkPending))
+        applyShrink(len);
+    return growFor(len);
+}
+
+void RingBuffer::noteDrain()
+{
+    if (_growth.shrinkAfterReads == 0)
+        return;
+
+    if (size() > _capacity / 4)
+    {
+        _lowStreak = 0;
+        return;
+    }
+
+    // Read paths never reallocate (that would invalidate Views and
+    // getReadBuffer() pointers); the next write-side call does it
+    if (++_lowStreak >= _growth.shrinkAfterReads)
+        _shrinkPending = true;
+}
+
+void RingBuffer::applyShrink(size_t len)
+{
+    const size_t target = std::max(_minCapacity, _capacity / 2);
+    if (size() + len <= target)
+        reallocate(target);
+    _lowStreak = 0;
+    _shrinkPending = false;
+}
+
+void RingBuffer::shrinkToFit()
+{
+    size_t target = std::max(_minCapacity, size_t(1));
+    while (target < size())
+    {
+        target *= 2;
+    }
+
+    if (target < _capacity)
+        reallocate(target);
+    _lowStreak = 0;
+    _shrinkPending = false;
+}
+
+void RingBuffer::releaseMirror() noexcept
+{
+#if defined(INK_RINGBUFFER_HAS_MIRROR)
+    if (_mirror)
+        munmap(_mirror, _capacity * 2);
+#endif
+    _mirror = nullptr;
+}
+
 size_t RingBuffer::read(char* dest, size_t maxLen)
 {
-    if (maxLen == 0 || _size == 0)
+    const size_t toRead = std::min(maxLen, size());
+    if (toRead == 0)
         return 0;
 
-    const size_t toRead = std::min(maxLen, _size);
+    const size_t readIdx = index(_readPos);
 
-    const size_t tail = _capacity - _readPos;
+    // Mirrored: the second mapping makes the whole range contiguous
+    const size_t tail = _mirror ? toRead : _capacity - readIdx;
     const size_t first = std::min(toRead, tail);
 
     // First chunk
-    memcpy(dest, _buffer.data() + _readPos, first);
+    memcpy(dest, _data + readIdx, first);
 
     // Wrap-around chunk
     if (toRead > first)
-        memcpy(dest + first, _buffer.data(), toRead - first);
+        memcpy(dest + first, _data, toRead - first);
 
     _readPos += toRead;
-    if (_readPos >= _capacity)
-        _readPos -= _capacity;
 
-    _size -= toRead;
+    // Only a ring that has grown can shrink
+    if (INK_UNLIKELY(_capacity > _minCapacity))
+        noteDrain();
     return toRead;
 }
 
 size_t RingBuffer::write(const char* data, size_t len)
 {
-    if (len == 0 || _size == _capacity)
+    if (INK_UNLIKELY(_shrinkPending))
+        applyShrink(len);
+    // Past the cap, grow to it and write what fits
+    if (INK_UNLIKELY(len > _capacity - size()))
+        growFor(std::min(len, _growth.maxCapacity > size() ? _growth.maxCapacity - size() : size_t(0)));
+
+    const size_t toWrite = std::min(len, _capacity - size());
+    if (toWrite == 0)
         return 0;
 
-    const size_t toWrite = std::min(len, _capacity - _size);
+    const size_t writeIdx = index(_writePos);
 
-    const size_t tail = _capacity - _writePos;
+    const size_t tail = _mirror ? toWrite : _capacity - writeIdx;
     const size_t first = std::min(toWrite, tail);
 
-    memcpy(_buffer.data() + _writePos, data, first);
+    memcpy(_data + writeIdx, data, first);
 
      // Wrap-around chunk
     if (toWrite > first)
-        memcpy(_buffer.data(), data + first, toWrite - first);
+        memcpy(_data, data + first, toWrite - first);
 
     _writePos += toWrite;
-    if (_writePos >= _capacity)
-        _writePos -= _capacity;
-
-    _size += toWrite;
     return toWrite;
 }
 
@@ -73,47 +383,49 @@ size_t RingBuffer::write(const std::string& s)
 
 const char* RingBuffer::getReadBuffer(size_t& availableData) const
 {
-    if (_size == 0) {
+    const size_t used = size();
+    if (used == 0) {
         availableData = 0;
         return nullptr;
     }
 
-    if (_readPos < _writePos)
-        availableData = _writePos - _readPos; // Simple case: read position before write position
-    else
-        availableData = _capacity - _readPos; // Complex case: read position after write position (wrap-around)
+    const size_t readIdx = index(_readPos);
+
+    // Mirrored: everything readable is contiguous; otherwise stop at the
+    // physical end of the buffer
+    availableData = _mirror ? used : std::min(used, _capacity - readIdx);
 
-    return _buffer.data() + _readPos;
+    return _data + readIdx;
 }
 
 char* RingBuffer::getWriteBuffer(size_t& availableSpace)
 {
-    if (_size == _capacity) {
+    const size_t space = _capacity - size();
+    if (space == 0) {
         availableSpace = 0;
         return nullptr;
     }
 
-    if (_writePos >= _readPos)
-        availableSpace = _capacity - _writePos; // Write position at or after read position
-    else
-        availableSpace = _readPos - _writePos; // Write position before read position
+    const size_t writeIdx = index(_writePos);
 
-    return _buffer.data() + _writePos;
+    // Mirrored: all free space is contiguous; otherwise stop at the
+    // physical end of the buffer
+    availableSpace = _mirror ? space : std::min(space, _capacity - writeIdx);
+
+    return _data + writeIdx;
 }
 
 void RingBuffer::advanceReadPos(size_t len)
 {
-    size_t bytesToAdvance = std::min(len, _size);
-    _readPos = (_readPos + bytesToAdvance) % _capacity;
-    _size -= bytesToAdvance;
+    _readPos += std::min(len, size());
+    if (INK_UNLIKELY(_capacity > _minCapacity))
+        noteDrain();
 }
 
 // Advance write position after writing data
 void RingBuffer::advanceWritePos(size_t len)
 {
-    size_t bytesToAdvance = std::min(len, _capacity - _size);
-    _writePos = (_writePos + bytesToAdvance) % _capacity;
-    _size += bytesToAdvance;
+    _writePos += std::min(len, _capacity - size());
 }
 
 // Clear buffer
@@ -121,7 +433,145 @@ void RingBuffer::clear()
 {
     _readPos = 0;
     _writePos = 0;
-    _size = 0;
 }
 
+size_t RingBuffer::View::copyTo(char* dest) const
+{
+    memcpy(dest, first.data(), first.size());
+    memcpy(dest + first.size(), second.data(), second.size());
+    return size();
+}
+
+RingBuffer::View RingBuffer::peek(size_t offset, size_t len) const
+{
+    const size_t used = size();
+    if (offset >= used)
+        return View{};
+
+    len = std::min(len, used - offset);
+    const size_t idx = index(_readPos + offset);
+    const size_t first = _mirror ? len : std::min(len, _capacity - idx);
+
+    return View{ std::string_view(_data + idx, first), std::string_view(_data, len - first) };
+}
+
+std::optional<size_t> RingBuffer::findDelimiter(std::string_view delim, size_t from) const
+{
+    const size_t m = delim.size();
+    const View v = peek(0, size());
+    if (m == 0 || from + m > v.size())
+        return std::nullopt;
+
+    const size_t n1 = v.first.size();
+
+    // Matches wholly inside the first segment
+    if (from < n1)
+    {
+        const char* hit = searchSegment(v.first.data() + from, n1 - from, delim);
+        if (hit)
+            return static_cast<size_t>(hit - v.first.data());
+    }
+
+    if (v.second.empty())
+        return std::nullopt;
+
+    // Matches straddling the wrap point: start in the last m - 1 bytes of
+    // the first segment
+    for (size_t i = std::max(from, n1 >= m - 1 ? n1 - (m - 1) : 0); i < n1 && i + m <= v.size(); ++i)
+    {
+        size_t k = 0;
+        while (k < m && v[i + k] == delim[k])
+            ++k;
+        if (k == m)
+            return i;
+    }
+
+    // Matches wholly inside the second segment
+    const size_t off2 = from > n1 ? from - n1 : 0;
+    const char* hit = searchSegment(v.second.data() + off2, v.second.size() - off2, delim);
+    if (hit)
+        return n1 + static_cast<size_t>(hit - v.second.data());
+
+    return std::nullopt;
+}
+
+std::optional<RingBuffer::View> RingBuffer::peekFrame(size_t lengthPrefixBytes) const
+{
+    if (lengthPrefixBytes == 0 || lengthPrefixBytes > sizeof(u64))
+        return std::nullopt;
+
+    const View prefix = peek(0, lengthPrefixBytes);
+    if (prefix.size() < lengthPrefixBytes)
+        return std::nullopt;
+
+    u64 len = 0;
+    for (size_t i = 0; i < lengthPrefixBytes; ++i)
+        len = (len << 8) | static_cast<u8>(prefix[i]);
+
+    if (len > size() - lengthPrefixBytes)
+        return std::nullopt;
+
+    return peek(lengthPrefixBytes, static_cast<size_t>(len));
+}
+
+#if !defined(INK_PLATFORM_WINDOWS)
+isize RingBuffer::readFrom(int fd, size_t maxLen)
+{
+    if (INK_UNLIKELY(_shrinkPending))
+        applyShrink(1);
+
+    // A growable ring never reports "full" while it may still grow
+    if (size() == _capacity)
+        growFor(1);
+
+    // No room is not EOF: report it the way a full socket buffer would
+    const size_t toRead = std::min(maxLen, _capacity - size());
+    if (toRead == 0)
+    {
+        errno = ENOBUFS;
+        return -1;
+    }
+
+    // Free space runs from the write slot to the end, then wraps to the start
+    const size_t writeIdx = index(_writePos);
+    iovec iov[2];
+    const size_t first = _mirror ? toRead : std::min(toRead, _capacity - writeIdx);
+    iov[0].iov_base = _data + writeIdx;
+    iov[0].iov_len = first;
+    iov[1].iov_base = _data;
+    iov[1].iov_len = toRead - first;
+
+    const ssize_t n = readv(fd, iov, iov[1].iov_len ? 2 : 1);
+    if (n > 0)
+        _writePos += static_cast<u64>(n);
+
+    return static_cast<isize>(n);
+}
+
+isize RingBuffer::writeTo(int fd, size_t maxLen)
+{
+    const size_t toWrite = std::min(maxLen, size());
+    if (toWrite == 0)
+        return 0;
+
+    const size_t readIdx = index(_readPos);
+    iovec iov[2];
+    const size_t first = _mirror ? toWrite : std::min(toWrite, _capacity - readIdx);
+    iov[0].iov_base = _data + readIdx;
+    iov[0].iov_len = first;
+    iov[1].iov_base = _data;
+    iov[1].iov_len = toWrite - first;
+
+    const ssize_t n = writev(fd, iov, iov[1].iov_len ? 2 : 1);
+    if (n > 0)
+    {
+        _readPos += static_cast<u64>(n);
+        if (_capacity > _minCapacity)
+            noteDrain();
+    }
+
+    return static_cast<isize>(n);
+}
+#endif
+
 }
@@ -0,0 +1,205 @@
+#include "../include/ink/SpscRingBuffer.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace ink {
+
+SpscRingBuffer::SpscRingBuffer(size_t capacity, u32 options) :
+    _writePos(0),
+    _cachedReadPos(0),
+    _readPos(0),
+    _cachedWritePos(0),
+    _signal(0),
+    _capacity(detail::roundPow2(INK_MAX(capacity, size_t(1)))),
+    _mask(_capacity - 1),
+    _blocking(INK_FLAG_CHECK(options, Blocking)),
+    _closed(false)
+{
+    _buffer.resize(_capacity);
+}
+
+void SpscRingBuffer::publish(std::atomic<u64>& counter, u64 value)
+{
+    counter.store(value, std::memory_order_release);
+    if (_blocking)
+        signal();
+}
+
+void SpscRingBuffer::signal()
+{
+    // std::atomic::wait only returns once the value changes, so waking
+    // (including for close()) means bumping the epoch, not just notifying.
+    _signal.fetch_add(1, std::memory_order_acq_rel);
+    _signal.notify_all();
+}
+
+size_t SpscRingBuffer::freeSpace(u64 writePos, size_t wanted)
+{
+    size_t space = _capacity - static_cast<size_t>(writePos - _cachedReadPos);
+
+    // Only go to the consumer's line when the cached view falls short
+    if (space < wanted)
+    {
+        _cachedReadPos = _readPos.load(std::memory_order_acquire);
+        space = _capacity - static_cast<size_t>(writePos - _cachedReadPos);
+    }
+    return space;
+}
+
+size_t SpscRingBuffer::write(const char* data, size_t len)
+{
+    const u64 writePos = _writePos.load(std::memory_order_relaxed);
+    const size_t toWrite = std::min(len, freeSpace(writePos, len));
+    if (toWrite == 0)
+        return 0;
+
+    const size_t index = static_cast<size_t>(writePos) & _mask;
+    const size_t first = std::min(toWrite, _capacity - index);
+
+    memcpy(_buffer.data() + index, data, first);
+
+    // Wrap-around chunk
+    if (toWrite > first)
+        memcpy(_buffer.data(), data + first, toWrite - first);
+
+    publish(_writePos, writePos + toWrite);
+    return toWrite;
+}
+
+char* SpscRingBuffer::getWriteBuffer(size_t& availableSpace)
+{
+    const u64 writePos = _writePos.load(std::memory_order_relaxed);
+    const size_t index = static_cast<size_t>(writePos) & _mask;
+    const size_t tail = _capacity - index;
+
+    const size_t space = freeSpace(writePos, tail);
+    if (space == 0) {
+        availableSpace = 0;
+        return nullptr;
+    }
+
+    availableSpace = std::min(space, tail);
+    return _buffer.data() + index;
+}
+
+void SpscRingBuffer::advanceWritePos(size_t len)
+{
+    const u64 writePos = _writePos.load(std::memory_order_relaxed);
+    publish(_writePos, writePos + std::min(len, freeSpace(writePos, len)));
+}
+
+bool SpscRingBuffer::waitForSpace(size_t minSpace)
+{
+    minSpace = std::min(minSpace, _capacity);
+    while (true)
+    {
+        const u32 seen = _signal.load(std::memory_order_acquire);
+        const u64 readPos = _readPos.load(std::memory_order_acquire);
+        _cachedReadPos = readPos;
+        const u64 writePos = _writePos.load(std::memory_order_relaxed);
+        if (_capacity - static_cast<size_t>(writePos - readPos) >= minSpace)
+            return true;
+        if (closed())
+            return false;
+
+        if (_blocking)
+            _signal.wait(seen, std::memory_order_acquire);
+        else
+            std::this_thread::yield();
+    }
+}
+
+size_t SpscRingBuffer::usedSpace(u64 readPos, size_t wanted)
+{
+    size_t used = static_cast<size_t>(_cachedWritePos - readPos);
+
+    // Only go to the producer's line when the cached view falls short
+    if (used < wanted)
+    {
+        _cachedWritePos = _writePos.load(std::memory_order_acquire);
+        used = static_cast<size_t>(_cachedWritePos - readPos);
+    }
+    return used;
+}
+
+size_t SpscRingBuffer::read(char* dest, size_t maxLen)
+{
+    const u64 readPos = _readPos.load(std::memory_order_relaxed);
+    const size_t toRead = std::min(maxLen, usedSpace(readPos, maxLen));
+    if (toRead == 0)
+        return 0;
+
+    const size_t index = static_cast<size_t>(readPos) & _mask;
+    const size_t first = std::min(toRead, _capacity - index);
+
+    memcpy(dest, _buffer.data() + index, first);
+
+    // Wrap-around chunk
+    if (toRead > first)
+        memcpy(dest + first, _buffer.data(), toRead - first);
+
+    publish(_readPos, readPos + toRead);
+    return toRead;
+}
+
+const char* SpscRingBuffer::getReadBuffer(size_t& availableData)
+{
+    const u64 readPos = _readPos.load(std::memory_order_relaxed);
+    const size_t index = static_cast<size_t>(readPos) & _mask;
+    const size_t tail = _capacity - index;
+
+    const size_t used = usedSpace(readPos, tail);
+    if (used == 0) {
+        availableData = 0;
+        return nullptr;
+    }
+
+    availableData = std::min(used, tail);
+    return _buffer.data() + index;
+}
+
+void SpscRingBuffer::advanceReadPos(size_t len)
+{
+    const u64 readPos = _readPos.load(std::memory_order_relaxed);
+    publish(_readPos, readPos + std::min(len, usedSpace(readPos, len)));
+}
+
+bool SpscRingBuffer::waitForData(size_t minData)
+{
+    minData = std::min(minData, _capacity);
+    while (true)
+    {
+        const u32 seen = _signal.load(std::memory_order_acquire);
+        const u64 writePos = _writePos.load(std::memory_order_acquire);
+        _cachedWritePos = writePos;
+        const u64 readPos = _readPos.load(std::memory_order_relaxed);
+        if (static_cast<size_t>(writePos - readPos) >= minData)
+            return true;
+        if (closed())
+        {
+            // close() may have raced with a final publish
+            return static_cast<size_t>(_writePos.load(std::memory_order_acquire) - readPos) >= minData;
+        }
+
+        if (_blocking)
+            _signal.wait(seen, std::memory_order_acquire);
+        else
+            std::this_thread::yield();
+    }
+}
+
+void SpscRingBuffer::close()
+{
+    _closed.store(true, std::memory_order_release);
+    signal();
+}
+
+size_t SpscRingBuffer::size() const
+{
+    const u64 readPos = _readPos.load(std::memory_order_acquire);
+    const u64 writePos = _writePos.load(std::memory_order_acquire);
+    return static_cast<size_t>(writePos - readPos);
+}
+
+}
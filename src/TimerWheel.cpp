@@ -6,42 +6,70 @@ namespace ink {
 
 TimerWheel::TimerWheel(u32 ticksToLive, u32 tickIntervalMs) :
     _ticksToLive(ticksToLive),
-    _currentSlot(0),
+    _wheel(kLevels * kSlots, nullptr),
+    _now(0),
     _tickMs(tickIntervalMs),
     _lastTickMs(ink::utils::nowMillis())
 {
-    u32 requiredSize = _ticksToLive + 1;
-    // Get power of 2 number next tp requiredSize
-    u32 power = 1;
-    while (power < requiredSize)
-    {
-        power <<= 1;
-    }
-
-    _wheel.assign(power, nullptr);
-    _wheelMask = power - 1;
 }
 
 void TimerWheel::update(TimerNode* node)
+{
+    schedule(node, _ticksToLive);
+}
+
+void TimerWheel::schedule(TimerNode* node, u64 ticks)
 {
     // Unlink from old position (if any)
     unlink(node);
 
-    // Calculate new slot (Current + Timeout)
-    // If current is 5 and timeout is 60, newSlot is (5 + 60) % 60 = 5.
-    // This means it will expire exactly one full revolution
-    u32 newSlot = (_currentSlot + _ticksToLive) & _wheelMask;
+    node->expires = _now + ticks;
+    link(node);
+}
+
+void TimerWheel::scheduleAfterMillis(TimerNode* node, u64 delayMs, u64 nowMs)
+{
+    // The tick() call `k` calls from now runs at _lastTickMs + (k + 1) * _tickMs
+    const u64 dueMs = nowMs + delayMs;
+    const u64 firstMs = _lastTickMs + _tickMs;
+    u64 ticks = 0;
+    if (dueMs > firstMs && _tickMs)
+    {
+        ticks = (dueMs - firstMs + _tickMs - 1) / _tickMs;
+    }
+    schedule(node, ticks);
+}
+
+void TimerWheel::scheduleAfterMillis(TimerNode* node, u64 delayMs)
+{
+    scheduleAfterMillis(node, delayMs, ink::utils::nowMillis());
+}
+
+void TimerWheel::link(TimerNode* node)
+{
+    // Past kMaxTicks the node is parked as far out as the top level reaches
+    // and re-filed by its real expiry when that slot cascades
+    const u64 delta = INK_MIN(node->expires - _now, kMaxTicks - 1);
+    const u64 at = _now + delta;
+
+    u32 level = 0;
+    while (level + 1 < kLevels && delta >= (u64(1) << ((level + 1) * kSlotBits)))
+    {
+        ++level;
+    }
+
+    const u32 slot = level * kSlots + static_cast<u32>((at >> (level * kSlotBits)) & (kSlots - 1));
 
     // Link to new bucket
-    node->slotIndex = newSlot;
-    node->next = _wheel[newSlot];
+    node->slotIndex = slot;
+    node->next = _wheel[slot];
     node->prev = nullptr;
 
-    if (_wheel[newSlot])
+    if (_wheel[slot])
     {
-        _wheel[newSlot]->prev = node;
+        _wheel[slot]->prev = node;
     }
-    _wheel[newSlot] = node;
+    _wheel[slot] = node;
 }
 
 void TimerWheel::unlink(TimerNode* node)
@@ -64,13 +92,39 @@ void TimerWheel::unlink(TimerNode* node)
     node->next = nullptr;
 }
 
+void TimerWheel::cascade(u32 level)
+{
+    const u32 slot = level * kSlots + static_cast<u32>((_now >> (level * kSlotBits)) & (kSlots - 1));
+    TimerNode* node = _wheel[slot];
+    _wheel[slot] = nullptr;
+
+    while (node)
+    {
+        TimerNode* next = node->next;
+        link(node);
+        node = next;
+    }
+}
+
 TimerNode* TimerWheel::tick()
 {
-    // Get the bucket at the current hand
-    TimerNode* expiredList = _wheel[_currentSlot];
-    _wheel[_currentSlot] = nullptr;
+    // Entering a new level-0 revolution: pull the next span down, and keep
+    // going up while the level above wraps as well
+    if ((_now & (kSlots - 1)) == 0)
+    {
+        for (u32 level = 1; level < kLevels; ++level)
+        {
+            cascade(level);
+            if ((_now >> (level * kSlotBits)) & (kSlots - 1)) break;
+        }
+    }
+
+    // Get the bucket at the current hand; everything in it expires now
+    const u32 slot = static_cast<u32>(_now & (kSlots - 1));
+    TimerNode* expiredList = _wheel[slot];
+    _wheel[slot] = nullptr;
 
-    _currentSlot = (_currentSlot + 1) & _wheelMask;
+    ++_now;
     _lastTickMs += _tickMs;
 
     return expiredList;
@@ -88,4 +142,3 @@ u64 TimerWheel::timeToNextTickMillis(const u64& nowMs) const
 
 
 }
-
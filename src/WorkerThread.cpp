@@ -5,8 +5,8 @@
 namespace ink {
 
 WorkerThread::WorkerThread(Policy policy, size_t timeoutSecs) :
-    _isRunning(false),
-    _isProcessing(false),
+    _isRunning(std::in_place, false),
+    _isProcessing(std::in_place, false),
     _requestProcessing(false),
     _policy(policy),
     _timeoutMs(timeoutSecs * 1000)
@@ -22,10 +22,10 @@ void WorkerThread::start()
 {
     std::lock_guard<std::mutex> lock(_mutex);
 
-    if (_isRunning)
+    if (*_isRunning)
         return;
 
-    _isRunning = true;
+    *_isRunning = true;
     _requestProcessing = false;
 
     if (_onStartCallback)
@@ -40,10 +40,10 @@ void WorkerThread::stop()
 {
     {
         std::lock_guard<std::mutex> lock(_mutex);
-        if (!_isRunning)
+        if (!*_isRunning)
             return;
 
-        _isRunning = false;
+        *_isRunning = false;
         _requestProcessing = true;
     }
     _cv.notify_all();
@@ -92,17 +92,17 @@ void WorkerThread::setOnDestructionAction(WTCallback onDestructionCallback) noex
 
 void WorkerThread::_process()
 {
-    while (_isRunning)
+    while (*_isRunning)
     {
-        _isProcessing = true;
+        *_isProcessing = true;
         process();
-        _isProcessing = false;
+        *_isProcessing = false;
 
-        if (!_isRunning) break;
+        if (!*_isRunning) break;
 
         std::unique_lock<std::mutex> lock(_mutex);
         _cv.wait_for(lock, std::chrono::milliseconds(_timeoutMs), [this]() {
-            return !_isRunning || _requestProcessing;
+            return !*_isRunning || _requestProcessing;
         });
 
         _requestProcessing = false;
@@ -1,10 +1,23 @@
+#include <cerrno>
 #include <chrono>
 #include <thread>
 #include <cstdio>
 #include <cstdlib>
+#include <memory_resource>
 #include <optional>
+#include <semaphore>
+#include <set>
+#include <unordered_map>
 #include <variant>
 
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
 #include "../include/ink/ink.hpp"
 
 // ============================================================================
@@ -231,6 +244,372 @@ void test_ringbuffer()
     char moveOut[8] = {};
     moveDst.read(moveOut, 7);
     CHECK(std::string(moveOut, 7) == "movable");
+
+    // Mirrored layout: capacity rounds up to a page and both zero-copy
+    // accessors stay contiguous across the physical end of the buffer.
+    ink::RingBuffer mirror(100, ink::RingBuffer::Mirrored);
+    if (mirror.mirrored()) {
+        const size_t cap = mirror.capacity();
+        CHECK(cap >= 100);
+        CHECK(cap % 4096 == 0);
+
+        mirror.write(std::string(cap - 4, 'a'));
+        char sink[4096] = {};
+        while (mirror.size() > 0) mirror.read(sink, sizeof(sink));
+        // readPos/writePos now sit 4 bytes before the physical end
+        CHECK(mirror.write("wrapped-frame", 13) == 13);
+
+        size_t readable = 0;
+        const char* frame = mirror.getReadBuffer(readable);
+        CHECK(readable == 13);
+        CHECK(std::string_view(frame, readable) == "wrapped-frame");
+
+        size_t writable = 0;
+        mirror.getWriteBuffer(writable);
+        CHECK(writable == cap - 13);
+
+        ink::RingBuffer movedMirror(std::move(mirror));
+        CHECK(movedMirror.mirrored());
+        CHECK(!mirror.mirrored());
+        char out[13] = {};
+        CHECK(movedMirror.read(out, 13) == 13);
+        CHECK(std::string(out, 13) == "wrapped-frame");
+    }
+
+    // PowerOfTwo rounds capacity up and indexes with a mask; non power of
+    // two capacities still wrap correctly on the modulo path.
+    ink::RingBuffer pow2(100, ink::RingBuffer::PowerOfTwo);
+    CHECK(pow2.capacity() == 128);
+    ink::RingBuffer odd(10);
+    CHECK(odd.capacity() == 10);
+    bool oddIntact = true;
+    for (int round = 0; round < 7; ++round) {
+        CHECK(odd.write("abcdefg", 7) == 7); // crosses the end every other round
+        char tmp[7] = {};
+        CHECK(odd.read(tmp, 7) == 7);
+        if (std::string(tmp, 7) != "abcdefg") oddIntact = false;
+    }
+    CHECK(oddIntact);
+
+    // Delimiter scanning: a "\r\n" that straddles the physical end is found
+    // without consuming anything.
+    ink::RingBuffer lines(16);
+    lines.write("0123456789", 10);
+    lines.read(drain, 6);                       // readPos = 6
+    lines.write("GET /\r\nNEXTX", 12);          // "\r" at slot 15, "\n" at slot 0
+    auto crlf = lines.findDelimiter("\r\n");
+    CHECK(crlf.has_value() && *crlf == 9);
+    CHECK(lines.size() == 16);
+    auto line = lines.peek(0, *crlf);
+    std::string lineOut(line.size(), '\0');
+    line.copyTo(lineOut.data());
+    CHECK(lineOut == "6789GET /");
+    CHECK(!lines.findDelimiter("\r\n", *crlf + 1).has_value());
+    CHECK(lines.findDelimiter("NEXT").value_or(0) == 11);
+    auto whole = lines.peek(0, lines.size());
+    CHECK(whole.size() == 16);
+    CHECK(!whole.contiguous());
+    CHECK(whole[10] == '\n');
+    CHECK(!lines.findDelimiter("nope").has_value());
+
+    // Randomized cross-check of the SIMD search against std::string::find,
+    // with the data rotated so matches land in either segment or across.
+    ink::RingBuffer scan(256);
+    bool scanAgrees = true;
+    std::string corpus;
+    for (int i = 0; i < 200; ++i) corpus.push_back("ab\r\n"[(i * 7 + i / 3) % 4]);
+    const std::string needles[] = { "\r\n", "a", "\r\n\r\n", "bab\r", "abab\r\nab" };
+    for (size_t shift = 0; shift < 256; shift += 37) {
+        scan.clear();
+        std::string pad(shift, '-');
+        scan.write(pad);
+        scan.advanceReadPos(shift);
+        scan.write(corpus);
+        for (const std::string& needle : needles) {
+            auto found = scan.findDelimiter(needle);
+            const size_t expected = corpus.find(needle);
+            if (found.value_or(std::string::npos) != expected) scanAgrees = false;
+        }
+    }
+    CHECK(scanAgrees);
+
+    // Length-prefixed frames: incomplete frames are not reported, complete
+    // ones come back as views over both segments.
+    ink::RingBuffer frames(16);
+    frames.write("01234567", 8);
+    frames.advanceReadPos(8);                   // readPos = writePos = 8
+    frames.write("\x00\x05hel", 5);
+    CHECK(!frames.peekFrame(2).has_value());    // 3 of 5 payload bytes so far
+    frames.write("lo\x00\x01", 4);            // payload wraps past slot 15
+    auto frame = frames.peekFrame(2);
+    CHECK(frame.has_value() && frame->size() == 5);
+    if (frame) {
+        std::string payload(frame->size(), '\0');
+        frame->copyTo(payload.data());
+        CHECK(payload == "hello");
+        frames.advanceReadPos(2 + frame->size());
+    }
+    CHECK(!frames.peekFrame(2).has_value());    // next frame's payload pending
+    CHECK(!frames.peekFrame(0).has_value());
+
+    // Growth policy: writes double capacity (linearizing wrapped data) up to
+    // the cap, then truncate; sustained low occupancy shrinks it back.
+    ink::RingBuffer elastic(16);
+    elastic.setGrowthPolicy({ 64, 4 });
+    elastic.write("0123456789", 10);
+    elastic.read(drain, 6);                     // readPos = 6, data wraps next
+    CHECK(elastic.write("ABCDEFGHIJKLMNOP", 16) == 16);
+    CHECK(elastic.capacity() == 32);
+    {
+        size_t linear = 0;
+        const char* head = elastic.getReadBuffer(linear);
+        CHECK(linear == 20); // linearized by the copy
+        CHECK(std::string_view(head, 4) == "6789");
+    }
+    CHECK(elastic.write(std::string(100, 'z')) == 44); // capped at 64
+    CHECK(elastic.capacity() == 64);
+    CHECK(elastic.full());
+    CHECK(!elastic.reserve(1));
+
+    char sinkBuf[64];
+    elastic.read(sinkBuf, 57);                  // 7 bytes left: below a quarter
+    const ink::RingBuffer::View held = elastic.peek(0, 7);
+    for (int i = 0; i < 3; ++i) elastic.read(sinkBuf, 1);
+    CHECK(elastic.capacity() == 64);            // reads never reallocate...
+    CHECK(held.first.data() + 3 == elastic.peek(0, 4).first.data());
+    CHECK(elastic.size() == 4);
+    char tailBytes[4] = {};
+    elastic.read(tailBytes, 4);
+    CHECK(std::string(tailBytes, 4) == "zzzz");
+    elastic.write("abc", 3);
+    CHECK(elastic.capacity() == 32);            // ...the next write halves it
+    CHECK(elastic.size() == 3);
+    elastic.shrinkToFit();
+    CHECK(elastic.capacity() == 16);
+    CHECK(elastic.size() == 3);
+    CHECK(elastic.reserve(40));
+    CHECK(elastic.capacity() == 64);
+
+    // The cap is rounded down to what the options can allocate, so growth
+    // never overshoots it.
+    ink::RingBuffer capped(16, ink::RingBuffer::PowerOfTwo);
+    capped.setGrowthPolicy({ 100, 0 });
+    CHECK(capped.growthPolicy().maxCapacity == 64);
+    CHECK(!capped.reserve(100) && capped.capacity() == 16); // fails up front
+    CHECK(capped.write(std::string(100, 'c')) == 64);        // writes fill to the cap
+    CHECK(capped.capacity() == 64);
+
+    // Requests past the cap fail at once instead of wrapping the size
+    // arithmetic, and a growth allocation that throws leaves the ring as
+    // it was.
+    ink::RingBuffer huge(16);
+    huge.setGrowthPolicy({ size_t(1) << 20, 0 });
+    huge.write("abc", 3);
+    CHECK(!huge.reserve(static_cast<size_t>(-1) / 2 + 1) && huge.capacity() == 16);
+    CHECK(!huge.reserve(static_cast<size_t>(-1)) && huge.size() == 3);
+    huge.setGrowthPolicy({ static_cast<size_t>(-1), 0 });
+    bool growthThrew = false;
+    try { (void)huge.reserve(static_cast<size_t>(-1) / 2); } catch (const std::exception&) { growthThrew = true; }
+    char hugeBytes[3] = {};
+    CHECK(growthThrew && huge.capacity() == 16 && huge.read(hugeBytes, 3) == 3);
+    CHECK(std::string(hugeBytes, 3) == "abc" && huge.write("xyz", 3) == 3);
+
+    // Fixed-size rings (the default) never grow.
+    ink::RingBuffer fixed(16);
+    CHECK(!fixed.reserve(17));
+    CHECK(fixed.write(std::string(20, 'x')) == 16);
+
+#if !defined(INK_PLATFORM_WINDOWS)
+    // Direct fd I/O: both directions split across the wrap point.
+    int fds[2];
+    CHECK(pipe(fds) == 0);
+    ink::RingBuffer io(16);
+    io.write("0123456789", 10);
+    io.read(drain, 6);                 // readPos = 6, writePos = 10
+    CHECK(write(fds[1], "ABCDEFGHIJKL", 12) == 12);
+    CHECK(io.readFrom(fds[0]) == 12);  // fills 10..15 then 0..5
+    CHECK(io.full());
+    errno = 0;
+    CHECK(io.readFrom(fds[0]) == -1 && errno == ENOBUFS); // full: fd is not touched
+
+    CHECK(io.writeTo(fds[1], 14) == 14); // 6..15 then 0..3
+    CHECK(io.size() == 2);
+    char piped[14] = {};
+    CHECK(::read(fds[0], piped, sizeof(piped)) == 14);
+    CHECK(std::string(piped, 14) == "6789ABCDEFGHIJ");
+    close(fds[1]);
+    errno = 0;
+    CHECK(io.readFrom(fds[0], 0) == -1 && errno == ENOBUFS); // no room asked for
+    CHECK(io.readFrom(fds[0]) == 0);   // EOF
+    close(fds[0]);
+#endif
+}
+
+// ============================================================================
+// SpscRingBuffer
+// ============================================================================
+void test_spscringbuffer()
+{
+    SECTION("SpscRingBuffer");
+
+    ink::SpscRingBuffer rb(10); // rounded up to 16
+    CHECK(rb.capacity() == 16);
+    CHECK(rb.empty());
+
+    CHECK(rb.write("0123456789", 10) == 10);
+    char drain[8] = {};
+    CHECK(rb.read(drain, 6) == 6);
+    CHECK(rb.write("ABCDEFGHIJKL", 12) == 12); // wraps, fills to capacity
+    CHECK(rb.write("x", 1) == 0);
+
+    // Zero-copy accessors stop at the physical end, like RingBuffer
+    size_t avail = 0;
+    const char* readPtr = rb.getReadBuffer(avail);
+    CHECK(readPtr != nullptr);
+    CHECK(avail == 10);
+    CHECK(std::string_view(readPtr, 4) == "6789");
+    rb.advanceReadPos(avail);
+    char rest[16] = {};
+    CHECK(rb.read(rest, sizeof(rest)) == 6);
+    CHECK(std::string(rest, 6) == "GHIJKL");
+    CHECK(rb.empty());
+
+    // Blocking waits: consumer parks until data arrives, close() releases it.
+    {
+        ink::SpscRingBuffer pipe(64, ink::SpscRingBuffer::Blocking);
+        std::thread producer([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            pipe.write("ping", 4);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            pipe.close();
+        });
+        CHECK(pipe.waitForData(4));
+        char ping[4] = {};
+        CHECK(pipe.read(ping, 4) == 4);
+        CHECK(std::string(ping, 4) == "ping");
+        CHECK(!pipe.waitForData());
+        producer.join();
+    }
+
+    // Streaming across two threads. The payload byte at stream offset i is
+    // (i & 0xFF); the consumer spot-checks both ends of every span.
+    constexpr size_t kTotal = size_t(16) << 20;
+    constexpr size_t kChunk = 4096;
+    std::vector<char> pattern(kChunk + 256);
+    for (size_t i = 0; i < pattern.size(); ++i) pattern[i] = static_cast<char>(i & 0xFF);
+
+    ink::SpscRingBuffer pipe(size_t(64) << 10, ink::SpscRingBuffer::Blocking);
+    bool intact = true;
+    std::thread producer([&]() {
+        size_t sent = 0;
+        while (sent < kTotal) {
+            size_t space = 0;
+            char* dst = pipe.getWriteBuffer(space);
+            if (!dst) {
+                pipe.waitForSpace();
+                continue;
+            }
+            const size_t n = std::min({space, kChunk, kTotal - sent});
+            memcpy(dst, pattern.data() + (sent & 0xFF), n);
+            pipe.advanceWritePos(n);
+            sent += n;
+        }
+        pipe.close();
+    });
+    size_t received = 0;
+    while (pipe.waitForData()) {
+        size_t n = 0;
+        const char* src = pipe.getReadBuffer(n);
+        if (src[0] != static_cast<char>(received & 0xFF) ||
+            src[n - 1] != static_cast<char>((received + n - 1) & 0xFF)) {
+            intact = false;
+        }
+        received += n;
+        pipe.advanceReadPos(n);
+    }
+    producer.join();
+    CHECK(received == kTotal);
+    CHECK(intact);
+}
+
+// ============================================================================
+// BroadcastRing
+// ============================================================================
+template<typename WaitStrategy>
+bool broadcastFanOut()
+{
+    constexpr u64 kEvents = 20000;
+    constexpr size_t kReaders = 3;
+    ink::BroadcastRing<u64, WaitStrategy> ring(16, kReaders);
+
+    std::vector<u64> sums(kReaders, 0);
+    std::vector<bool> ordered(kReaders, true);
+    std::vector<std::thread> readers;
+    for (size_t r = 0; r < kReaders; ++r) {
+        readers.emplace_back([&, r]() {
+            u64 expected = 0;
+            auto& reader = ring.reader(r);
+            while (reader.consume([&](const u64& v, u64 seq, bool) {
+                if (v != seq || seq != expected) ordered[r] = false;
+                ++expected;
+                sums[r] += v;
+            }) > 0) {}
+        });
+    }
+
+    // Batched claim/publish, 4 events at a time
+    for (u64 i = 0; i < kEvents; i += 4) {
+        const u64 first = ring.claim(4);
+        for (u64 k = 0; k < 4; ++k) ring[first + k] = first + k;
+        ring.publish(first, 4);
+    }
+    ring.close();
+    for (auto& t : readers) t.join();
+
+    const u64 expectedSum = kEvents * (kEvents - 1) / 2;
+    bool ok = true;
+    for (size_t r = 0; r < kReaders; ++r) {
+        ok = ok && sums[r] == expectedSum && ordered[r];
+    }
+    return ok;
+}
+
+void test_broadcastring()
+{
+    SECTION("BroadcastRing");
+
+    // The writer is gated by the slowest reader.
+    ink::BroadcastRing<int> ring(4, 2);
+    CHECK(ring.capacity() == 4);
+    for (int i = 0; i < 4; ++i) ring.push(i);
+    CHECK(!ring.tryClaim().has_value());
+
+    int seen = 0;
+    CHECK(ring.reader(0).poll([&](const int& v, u64, bool) { seen += v; }) == 4);
+    CHECK(seen == 6);
+    CHECK(!ring.tryClaim().has_value()); // reader 1 still holds every slot
+
+    // Manual batch read: waitFor() then commit() part of it
+    auto& slow = ring.reader(1);
+    const u64 end = slow.waitFor();
+    CHECK(end == 4);
+    CHECK(slow[0] == 0 && slow[3] == 3);
+    slow.commit(2);
+    auto claimed = ring.tryClaim(2);
+    CHECK(claimed.has_value() && *claimed == 4);
+    CHECK(!ring.tryClaim(1).has_value());
+
+    // A batch larger than the ring can never fit: rejected, not a hang.
+    ink::BroadcastRing<int> tiny(4, 1);
+    CHECK(!tiny.tryClaim(5).has_value());
+    bool tooLarge = false;
+    try { (void)tiny.claim(5); } catch (const std::length_error&) { tooLarge = true; }
+    CHECK(tooLarge);
+    CHECK(tiny.tryClaim(4).has_value());
+
+    CHECK(broadcastFanOut<ink::BusySpinWaitStrategy>());
+    CHECK(broadcastFanOut<ink::YieldingWaitStrategy>());
+    runtime([]() { CHECK(broadcastFanOut<ink::BlockingWaitStrategy>()); });
 }
 
 // ============================================================================
@@ -247,6 +626,14 @@ struct PoolProbe {
         ++liveCount;
         ++constructCount;
     }
+    PoolProbe(const PoolProbe& other) : value(other.value) {
+        ++liveCount;
+        ++constructCount;
+    }
+    PoolProbe(PoolProbe&& other) noexcept : value(other.value) {
+        ++liveCount;
+        ++constructCount;
+    }
     ~PoolProbe() {
         --liveCount;
         ++destructCount;
@@ -302,9 +689,352 @@ void test_objectpool()
 
         CHECK(pool.getRawBuffer() != nullptr);
         CHECK(pool.getRawBufferSize() > 0);
+
+        auto st = pool.stats();
+#if INK_ALLOCATOR_STATS
+        CHECK(st.live == 0 && st.peakLive == 20);
+#else
+        CHECK(st.live == 0 && st.peakLive == 0);
+#endif
+        CHECK(st.capacity >= 20 && st.slabs >= 3);
+        PoolProbe* held = pool.acquire(1);
+        CHECK(pool.stats().live == 1);
+        pool.release(held);
+
+        // PoolPtr releases on scope exit and on reset, and moves ownership.
+        {
+            ink::PoolPtr<PoolProbe> p = pool.make(5);
+            CHECK(p && p->value == 5);
+            CHECK(PoolProbe::liveCount == 1);
+            ink::PoolPtr<PoolProbe> q = std::move(p);
+            CHECK(!p && q->value == 5);
+            q = pool.make(6); // old object goes back first
+            CHECK(PoolProbe::liveCount == 1 && (*q).value == 6);
+            ink::PoolPtr<PoolProbe> r = pool.make(7);
+            PoolProbe* raw = r.detach();
+            CHECK(!r && PoolProbe::liveCount == 2);
+            pool.release(raw);
+            r.reset(); // no-op on an empty handle
+        }
+        CHECK(PoolProbe::liveCount == 0);
+        CHECK(pool.stats().live == 0);
+    }
+
+    // The free list lives in the slots: release/acquire is LIFO, and a
+    // huge initial slab costs nothing until slots are actually used.
+    {
+        ink::ObjectPool<u64, 1 << 20> pool;
+        u64* a = pool.acquire(1);
+        u64* b = pool.acquire(2);
+        CHECK(b > a); // fresh slots come out in address order
+        pool.release(a);
+        pool.release(b);
+        CHECK(pool.acquire(3) == b);
+        CHECK(pool.acquire(4) == a);
+        CHECK(pool.stats().capacity == (1u << 20) && pool.stats().slabs == 1);
+        pool.release(a);
+        pool.release(b);
+        CHECK(pool.stats().live == 0);
+    }
+
+#if INK_ALLOCATOR_DEBUG
+    // Debug mode: double release, write after release, overruns and leaks
+    // are reported instead of silently corrupting the pool.
+    {
+        static std::vector<std::string> reports;
+        reports.clear();
+        ink::AllocatorDebug::setHandler([](const char* what, const void*) { reports.emplace_back(what); });
+        {
+            ink::ObjectPool<u64, 4> pool;
+            u64* a = pool.acquire(1);
+            pool.release(a);
+            pool.release(a); // double release
+            *a = 42;         // write after release
+            u64* b = pool.acquire(2);
+            CHECK(b == a);
+            b[1] = 0;        // overrun into the canary
+            pool.release(b);
+            (void)pool.acquire(3); // leaked
+        }
+        ink::AllocatorDebug::setHandler(nullptr);
+        auto saw = [](const char* needle) {
+            for (const std::string& r : reports) if (r.find(needle) != std::string::npos) return true;
+            return false;
+        };
+        CHECK(saw("double release"));
+        CHECK(saw("write to released"));
+        CHECK(saw("overrun"));
+        CHECK(saw("still live"));
+    }
+#endif
+
+    // Slab export: every slab is listed at a stable index and reported to
+    // the callback (existing ones replayed on install); slabs added while
+    // the callback is installed are page mapped, the initial heap slab is not.
+    {
+        ink::ObjectPool<u64, 16> pool;
+        std::vector<ink::SlabRegion> seen;
+        pool.onSlabAdded([&](size_t index, const ink::SlabRegion& region) {
+            CHECK(index == seen.size());
+            seen.push_back(region);
+        });
+        CHECK(seen.size() == 1);
+
+        std::vector<u64*> held;
+        while (pool.slabCount() < 4) held.push_back(pool.acquire(held.size()));
+        const std::vector<ink::SlabRegion> regions = pool.slabRegions();
+        CHECK(regions.size() == 4 && seen.size() == 4);
+        bool matches = true;
+        for (size_t i = 0; i < regions.size(); ++i) {
+            matches &= regions[i].iov_base == seen[i].iov_base && regions[i].iov_len == seen[i].iov_len;
+            if (i == 0) continue;
+            matches &= reinterpret_cast<std::uintptr_t>(regions[i].iov_base) % ink::PageAllocator::pageSize() == 0;
+            matches &= regions[i].iov_len % ink::PageAllocator::pageSize() == 0;
+        }
+        CHECK(matches);
+        CHECK(regions[0].iov_len < ink::PageAllocator::pageSize()); // 16 slots, not a page
+        CHECK(pool.getRawBuffer() == regions[0].iov_base);
+        CHECK(pool.slabIndexOf(held.front()) == 0 && pool.slabIndexOf(held.back()) == 3);
+        u64 foreign = 0;
+        CHECK(pool.slabIndexOf(&foreign) == -1);
+
+#if !defined(_WIN32)
+        // The export is a valid iovec array: writev the first slot of every
+        // slab through a pipe and read the values back.
+        for (size_t i = 0; i < held.size(); ++i) *held[i] = i;
+        std::vector<u64> firsts;
+        for (const ink::SlabRegion& r : regions) firsts.push_back(*static_cast<u64*>(r.iov_base));
+        std::vector<iovec> iov(regions.size());
+        std::memcpy(iov.data(), regions.data(), regions.size() * sizeof(iovec));
+        for (iovec& v : iov) v.iov_len = sizeof(u64);
+        int fds[2];
+        CHECK(pipe(fds) == 0);
+        CHECK(writev(fds[1], iov.data(), static_cast<int>(iov.size())) == ssize_t(iov.size() * sizeof(u64)));
+        std::vector<u64> back(iov.size());
+        CHECK(read(fds[0], back.data(), back.size() * sizeof(u64)) == ssize_t(back.size() * sizeof(u64)));
+        CHECK(back == firsts);
+        close(fds[0]);
+        close(fds[1]);
+#endif
+        for (u64* p : held) pool.release(p);
+    }
+
+    // Config::exportSlabs maps the initial slab through the page allocator
+    // too, so every exported region is page aligned and whole pages long.
+    {
+        using Pool = ink::ObjectPool<u64, 16>;
+        Pool::Config config;
+        config.exportSlabs = true;
+        Pool pool(config);
+        u64* first = pool.acquire(1);
+        std::vector<ink::SlabRegion> regions = pool.slabRegions();
+        const size_t page = ink::PageAllocator::pageSize();
+        CHECK(regions.size() == 1 && pool.slabIndexOf(first) == 0);
+        CHECK(reinterpret_cast<std::uintptr_t>(regions[0].iov_base) % page == 0 && regions[0].iov_len % page == 0);
+        CHECK(pool.stats().capacity > 16); // the whole page is put to use
+        pool.release(first);
+    }
+
+    // Capped growth: at the cap acquire() follows the exhaustion policy.
+    {
+        using Pool = ink::ObjectPool<u64, 16>;
+        Pool::Config config;
+        config.maxCapacity = 1000;
+        config.onExhausted = Pool::ReturnNull;
+        Pool capped(config);
+        std::vector<u64*> held;
+        while (u64* p = capped.acquire(held.size())) held.push_back(p);
+        CHECK(held.size() == 1000 && capped.stats().capacity == 1000);
+        CHECK(!capped.make(1));
+        capped.release(held.back());
+        held.pop_back();
+        held.push_back(capped.acquire(7));
+        CHECK(held.back() != nullptr); // a released slot is reusable
+        for (u64* p : held) if (p) capped.release(p);
+
+        config.onExhausted = Pool::Throw;
+        config.maxCapacity = 1;
+        Pool strict(config);
+        u64* only = strict.acquire(1);
+        bool threw = false;
+        try { (void)strict.acquire(2); } catch (const std::bad_alloc&) { threw = true; }
+        CHECK(threw);
+        strict.release(only);
+
+        // Linear growth adds same-sized slabs; geometric ones double.
+        Pool::Config linearConfig;
+        linearConfig.growth = Pool::Linear;
+        Pool linear(linearConfig);
+        Pool geometric;
+        std::vector<u64*> a, b;
+        while (linear.slabCount() < 4) a.push_back(linear.acquire(0));
+        while (geometric.slabCount() < 4) b.push_back(geometric.acquire(0));
+        auto lr = linear.slabRegions();
+        auto gr = geometric.slabRegions();
+        CHECK(lr[3].iov_len == lr[1].iov_len);
+        CHECK(gr[3].iov_len == 4 * gr[1].iov_len);
+        for (u64* p : a) linear.release(p);
+        for (u64* p : b) geometric.release(p);
+    }
+
+    // shrink() returns idle slabs after a spike and keeps busy ones; freed
+    // indices are reported and reused.
+    {
+        ink::ObjectPool<PoolProbe, 4> pool;
+        std::vector<size_t> removed;
+        pool.onSlabRemoved([&](size_t index) { removed.push_back(index); });
+        std::vector<PoolProbe*> spike;
+        while (pool.slabCount() < 5) spike.push_back(pool.acquire(int(spike.size())));
+        const size_t peakCapacity = pool.stats().capacity;
+
+        PoolProbe* keeper = spike[0]; // pins slab 0
+        for (size_t i = 1; i < spike.size(); ++i) pool.release(spike[i]);
+        const size_t released = pool.shrink();
+        CHECK(released > 0 && pool.stats().capacity == peakCapacity - released);
+        CHECK(pool.stats().slabs == 1 && removed.size() == 4);
+        CHECK(pool.slabRegions()[1].iov_base == nullptr && pool.slabCount() == 5);
+        CHECK(pool.shrink() == 0); // slab 0 still has a live object
+        CHECK(keeper->value == 0);
+
+        // The pool keeps working: surviving free slots come back first,
+        // then new slabs fill the freed indices.
+        std::vector<PoolProbe*> again;
+        bool intact = true;
+        while (pool.stats().slabs < 3) again.push_back(pool.acquire(int(again.size())));
+        for (size_t i = 0; i < again.size(); ++i) intact &= again[i]->value == int(i);
+        CHECK(intact);
+        CHECK(pool.slabIndexOf(again.back()) == 2 && pool.slabCount() == 5);
+        for (PoolProbe* p : again) pool.release(p);
+        pool.release(keeper);
+
+        // keepSlots leaves capacity in place
+        const size_t before = pool.stats().capacity;
+        pool.shrink(before);
+        CHECK(pool.stats().capacity == before);
+        pool.shrink();
+        CHECK(pool.stats().capacity == 0 && pool.stats().slabs == 0);
+        PoolProbe* fresh = pool.acquire(9); // grows again from iSize
+        CHECK(fresh->value == 9 && pool.slabIndexOf(fresh) == 0);
+        pool.release(fresh);
+        CHECK(PoolProbe::liveCount == 0);
+    }
+
+    // Huge-page slabs are 2 MB aligned and fully used.
+    {
+        ink::ObjectPool<PoolProbe, 4, ink::PageAllocator::Transparent> pool;
+        CHECK((reinterpret_cast<std::uintptr_t>(pool.getRawBuffer()) % ink::PageAllocator::kHugePageSize) == 0);
+        CHECK(pool.getRawBufferSize() == ink::PageAllocator::kHugePageSize);
+        std::vector<PoolProbe*> many;
+        for (int i = 0; i < 1000; ++i) many.push_back(pool.acquire(i));
+        CHECK(pool.getRawBufferSize() == ink::PageAllocator::kHugePageSize); // no second slab yet
+        for (PoolProbe* p : many) pool.release(p);
+        CHECK(PoolProbe::liveCount == 0);
     }
 }
 
+// ============================================================================
+// TypedRingBuffer
+// ============================================================================
+struct Tick {
+    u64 ts;
+    f64 price;
+};
+
+void test_typedringbuffer()
+{
+    SECTION("TypedRingBuffer");
+
+    ink::TypedRingBuffer<Tick> ticks(6); // rounded up to 8
+    CHECK(ticks.capacity() == 8);
+    CHECK(ticks.peek() == nullptr);
+
+    for (u64 i = 0; i < 8; ++i) CHECK(ticks.emplace(i, 100.0 + i));
+    CHECK(ticks.full());
+    CHECK(!ticks.emplace(u64(8), 108.0)); // RejectWhenFull
+    CHECK(ticks.peek()->ts == 0);
+    CHECK(ticks[7].ts == 7);
+
+    std::array<Tick, 5> batch{};
+    CHECK(ticks.pop_n(batch) == 5);
+    CHECK(batch[0].ts == 0 && batch[4].ts == 4);
+
+    // Batch producer: wraps, so the first write span stops at the slab end
+    auto ws = ticks.writeSpan();
+    CHECK(ws.size() == 5);
+    for (size_t i = 0; i < ws.size(); ++i) ws[i] = Tick{ 10 + i, 0.0 };
+    ticks.commit(ws.size());
+    CHECK(ticks.full());
+
+    auto rs = ticks.readSpan();
+    CHECK(rs.size() == 3); // slots 5..7 before the physical end
+    CHECK(rs[0].ts == 5);
+    ticks.consume(rs.size());
+    CHECK(ticks.readSpan().size() == 5);
+    CHECK(ticks.peek()->ts == 10);
+
+    // OverwriteOldest keeps a "last N" window and destroys what it drops.
+    PoolProbe::liveCount = 0;
+    {
+        ink::TypedRingBuffer<PoolProbe> window(4, ink::TypedRingBuffer<PoolProbe>::OverwriteOldest);
+        for (int i = 0; i < 10; ++i) CHECK(window.emplace(i));
+        CHECK(window.size() == 4);
+        CHECK(window.overwritten() == 6);
+        CHECK(PoolProbe::liveCount == 4);
+        CHECK(window.peek()->value == 6);
+        CHECK(window[3].value == 9);
+
+        ink::TypedRingBuffer<PoolProbe> moved(std::move(window));
+        CHECK(moved.size() == 4);
+        CHECK(moved.pop());
+        CHECK(PoolProbe::liveCount == 3);
+        CHECK(!window.emplace(1)); // moved-from ring has no slots
+    }
+    CHECK(PoolProbe::liveCount == 0);
+
+    // Overwriting from the oldest record itself, and a throwing constructor
+    // that must leave the full ring untouched.
+    {
+        using Strings = ink::TypedRingBuffer<std::string>;
+        Strings window(2, Strings::OverwriteOldest);
+        window.push(std::string(40, 'a'));
+        window.push(std::string(40, 'b'));
+        CHECK(window.push(window[0]));
+        CHECK(window[0] == std::string(40, 'b') && window[1] == std::string(40, 'a'));
+        CHECK(window.push(*window.peek()));
+        CHECK(window[1] == std::string(40, 'b') && window.overwritten() == 2);
+
+        struct Picky {
+            int v;
+            explicit Picky(int x) : v(x) { if (x < 0) throw std::runtime_error("picky"); }
+        };
+        ink::TypedRingBuffer<Picky> picky(2, ink::TypedRingBuffer<Picky>::OverwriteOldest);
+        picky.emplace(1);
+        picky.emplace(2);
+        bool threw = false;
+        try { picky.emplace(-1); } catch (const std::runtime_error&) { threw = true; }
+        CHECK(threw && picky.size() == 2 && picky[0].v == 1 && picky.overwritten() == 0);
+
+        // A move that may throw could lose the dropped record, so such types
+        // only get RejectWhenFull.
+        struct CopyOnly {
+            int v;
+            CopyOnly(const CopyOnly& other) : v(other.v) {}
+        };
+        bool rejected = false;
+        try { ink::TypedRingBuffer<CopyOnly> bad(2, ink::TypedRingBuffer<CopyOnly>::OverwriteOldest); }
+        catch (const std::invalid_argument&) { rejected = true; }
+        CHECK(rejected);
+        ink::TypedRingBuffer<CopyOnly> fine(2);
+        CHECK(fine.capacity() == 2);
+    }
+
+    ink::TypedRingBuffer<std::string> strings(2);
+    strings.push(std::string(64, 'a'));
+    std::string out;
+    CHECK(strings.pop(out) && out.size() == 64);
+    CHECK(strings.empty());
+}
+
 // ============================================================================
 // ArenaAllocator (InkedArena)
 // ============================================================================
@@ -338,6 +1068,569 @@ void test_arena_allocator()
 
     arena.arena_destroy(&a);
     CHECK(a.head == nullptr);
+
+    // std::pmr containers and typed allocators on top of an arena.
+    ink::InkedArena::Arena req{};
+    ink::InkedArena::arena_init(&req, 4096);
+    {
+        ink::ArenaResource resource(&req);
+        std::pmr::vector<int> ints(&resource);
+        for (int i = 0; i < 1000; ++i) ints.push_back(i); // spills past one block
+        CHECK(ints.size() == 1000 && ints[999] == 999);
+
+        std::pmr::string text("a string long enough to defeat the small-string buffer", &resource);
+        CHECK(text.size() > 32);
+
+        std::pmr::unordered_map<int, std::pmr::string> byId(&resource);
+        byId.emplace(1, "one");
+        byId.emplace(2, "two");
+        CHECK(byId.at(2) == "two");
+        CHECK(byId.get_allocator().resource()->is_equal(resource));
+
+        ink::ArenaAllocator<u64> typed(&req);
+        std::vector<u64, ink::ArenaAllocator<u64>> wide(typed);
+        wide.assign(300, 7);
+        CHECK(wide.size() == 300 && wide.back() == 7);
+        CHECK((reinterpret_cast<std::uintptr_t>(wide.data()) % alignof(u64)) == 0);
+        CHECK(ink::ArenaAllocator<char>(typed) == typed);
+    }
+    ink::InkedArena::arena_reset(&req);
+    ink::InkedArena::arena_destroy(&req);
+
+    // Savepoints: nested scopes rewind in LIFO order, dropping any blocks
+    // that were chained on inside them.
+    ink::InkedArena::Arena phases{};
+    ink::InkedArena::arena_init(&phases, 1024);
+    void* keep = ink::InkedArena::arena_alloc(&phases, 104, 8);
+    ink::InkedArena::ArenaBlock* firstBlock = phases.head;
+    const size_t keptOffset = phases.head->offset;
+    {
+        ink::ArenaScope parse(&phases);
+        ink::InkedArena::arena_alloc(&phases, 512, 8);
+        {
+            ink::ArenaScope transform(&phases);
+            for (int i = 0; i < 8; ++i) ink::InkedArena::arena_alloc(&phases, 900, 8);
+            CHECK(phases.head != firstBlock); // spilled into new blocks
+        }
+        CHECK(phases.head == firstBlock);
+        CHECK(phases.head->offset == keptOffset + 512);
+    }
+    CHECK(phases.head == firstBlock);
+    CHECK(phases.head->offset == keptOffset);
+
+    auto mark = ink::InkedArena::arena_mark(&phases);
+    void* scratch = ink::InkedArena::arena_alloc(&phases, 64, 8);
+    ink::InkedArena::arena_rewind(&phases, mark);
+    CHECK(ink::InkedArena::arena_alloc(&phases, 64, 8) == scratch); // space reused
+    CHECK(keep != scratch);
+    ink::InkedArena::arena_destroy(&phases);
+
+    // Reset/alloc cycles reuse spare blocks instead of mapping new ones;
+    // arena_trim and retain_bytes hand the excess back.
+    auto countBlocks = [](ink::InkedArena::ArenaBlock* b) {
+        size_t n = 0;
+        for (; b; b = b->next) ++n;
+        return n;
+    };
+    ink::InkedArena::Arena cyc{};
+    ink::InkedArena::arena_init(&cyc, 1024);
+    const size_t blockBytes = cyc.head->size; // rounded up to a page
+    const size_t chunk = blockBytes - blockBytes / 8;
+    std::set<ink::InkedArena::ArenaBlock*> seen;
+    for (int round = 0; round < 5; ++round)
+    {
+        for (int i = 0; i < 6; ++i) ink::InkedArena::arena_alloc(&cyc, chunk, 8);
+        for (auto* b = cyc.head; b; b = b->next) seen.insert(b);
+        ink::InkedArena::arena_reset(&cyc);
+        CHECK(countBlocks(cyc.head) == 1);
+        CHECK(cyc.head->offset == 0);
+    }
+    CHECK(seen.size() == 6); // same six blocks every round
+    CHECK(countBlocks(cyc.spare) == 5);
+
+    void* huge = ink::InkedArena::arena_alloc(&cyc, 2 * blockBytes, 8); // no spare fits
+    CHECK(huge != nullptr);
+    CHECK(seen.count(cyc.head) == 0);
+    CHECK(countBlocks(cyc.spare) == 5);
+
+    ink::InkedArena::arena_trim(&cyc, 0); // in-use blocks survive
+    CHECK(cyc.spare == nullptr);
+    CHECK(countBlocks(cyc.head) == 2);
+
+    cyc.retain_bytes = 3 * blockBytes;
+    for (int i = 0; i < 6; ++i) ink::InkedArena::arena_alloc(&cyc, chunk, 8);
+    ink::InkedArena::arena_reset(&cyc);
+    size_t mapped = 0;
+    for (auto* b = cyc.head; b; b = b->next) mapped += b->size;
+    for (auto* b = cyc.spare; b; b = b->next) mapped += b->size;
+    CHECK(mapped <= 3 * blockBytes);
+    ink::InkedArena::arena_destroy(&cyc);
+    CHECK(cyc.head == nullptr && cyc.spare == nullptr);
+
+    // Reserve mode: one contiguous region committed in steps, decommitted
+    // back to retain_bytes on reset.
+    ink::InkedArena::Arena reserve{};
+    ink::InkedArena::arena_init_reserve(&reserve, size_t(64) << 20, 64 * 1024);
+    CHECK(reserve.head != nullptr && reserve.head->reserved >= (size_t(64) << 20));
+    CHECK(reserve.head->size < 128 * 1024); // nothing like 64 MB committed yet
+    u8* first = static_cast<u8*>(ink::InkedArena::arena_alloc(&reserve, 4096, 16));
+    u8* prev = first;
+    bool contiguous = true;
+    for (int i = 0; i < 2048; ++i) // 8 MB more, all inside the reservation
+    {
+        u8* p = static_cast<u8*>(ink::InkedArena::arena_alloc(&reserve, 4096, 16));
+        contiguous = contiguous && p == prev + 4096;
+        p[0] = p[4095] = u8(i);
+        prev = p;
+    }
+    CHECK(contiguous);
+    CHECK(reserve.head->next == nullptr && reserve.spare == nullptr);
+    CHECK(reserve.head->size >= 2049 * 4096 && reserve.head->size < (size_t(9) << 20));
+
+    reserve.retain_bytes = 256 * 1024;
+    ink::InkedArena::arena_reset(&reserve);
+    CHECK(reserve.head->size <= 256 * 1024);
+    CHECK(ink::InkedArena::arena_alloc(&reserve, 1 << 20, 64) != nullptr); // recommits in place
+    CHECK(reserve.head->next == nullptr && reserve.head->size >= (1 << 20));
+    ink::InkedArena::arena_destroy(&reserve);
+
+    // A commit step that is not a power of two (3 pages): the first commit
+    // is exactly one step including the header, and every commit ends on a
+    // step boundary that covers the allocation.
+    {
+        const size_t page = ink::PageAllocator::pageSize();
+        const size_t step = 3 * page;
+        const size_t header = sizeof(ink::InkedArena::ArenaBlock);
+        ink::InkedArena::Arena odd{};
+        ink::InkedArena::arena_init_reserve(&odd, size_t(8) << 20, step);
+        CHECK(odd.head != nullptr && odd.head->size + header == step);
+        bool covered = true;
+        for (size_t want : { 5 * page, 7 * page + 100, 11 * page }) {
+            u8* p = static_cast<u8*>(ink::InkedArena::arena_alloc(&odd, want, 16));
+            covered = covered && p != nullptr;
+            if (!p) break;
+            p[0] = p[want - 1] = 1; // faults if the commit fell short
+            covered = covered && (odd.head->size + header) % step == 0;
+            covered = covered && odd.head->offset <= odd.head->size;
+        }
+        CHECK(covered && odd.head->next == nullptr);
+        ink::InkedArena::arena_destroy(&odd);
+    }
+
+    ink::InkedArena::Arena hugeArena{};
+    ink::InkedArena::arena_init(&hugeArena, 1 << 20, ink::InkedArena::HugePages);
+    CHECK((reinterpret_cast<std::uintptr_t>(hugeArena.head) % ink::PageAllocator::kHugePageSize) == 0);
+    CHECK(hugeArena.head->size + sizeof(ink::InkedArena::ArenaBlock) == ink::PageAllocator::kHugePageSize);
+    CHECK(ink::InkedArena::arena_alloc(&hugeArena, 1 << 20, 64) != nullptr);
+    ink::InkedArena::arena_destroy(&hugeArena);
+
+    ink::InkedArena::Arena eager{};
+    ink::InkedArena::arena_init(&eager, 64 * 1024, ink::InkedArena::Prefault);
+    CHECK(ink::InkedArena::arena_alloc(&eager, 1024, 8) != nullptr);
+    ink::InkedArena::arena_destroy(&eager);
+
+    // Typed construction: destructors run newest first on reset, rewind
+    // and destroy; trivially destructible types register nothing.
+    ink::InkedArena::Arena graph{};
+    ink::InkedArena::arena_init(&graph, 4096);
+    std::vector<int> order;
+    struct Tracked {
+        std::vector<int>* log;
+        int id;
+        std::string payload;
+        Tracked() : log(nullptr), id(-1) {}
+        Tracked(std::vector<int>* l, int i) : log(l), id(i), payload(64, 'x') {}
+        ~Tracked() { if (log) log->push_back(id); }
+    };
+    ink::InkedArena::arena_new<Tracked>(&graph, &order, 1);
+    ink::InkedArena::arena_new<Tracked>(&graph, &order, 2);
+    u64* plain = ink::InkedArena::arena_new<u64>(&graph, u64(7));
+    CHECK(*plain == 7);
+    {
+        ink::ArenaScope scope(&graph);
+        ink::InkedArena::arena_new<Tracked>(&graph, &order, 3);
+        auto* strings = ink::InkedArena::arena_new_array<std::string>(&graph, 50);
+        strings[49] = std::string(100, 'y'); // heap-backed, must be freed
+    }
+    CHECK(order == std::vector<int>{ 3 });
+    Tracked* arr = ink::InkedArena::arena_new_array<Tracked>(&graph, 3);
+    CHECK(arr[2].id == -1);
+    ink::InkedArena::arena_reset(&graph);
+    CHECK((order == std::vector<int>{ 3, 2, 1 }));
+    CHECK(graph.finalizers == nullptr);
+
+    ink::InkedArena::arena_new<Tracked>(&graph, &order, 4);
+    ink::InkedArena::arena_destroy(&graph);
+    CHECK((order == std::vector<int>{ 3, 2, 1, 4 }));
+
+    // A throwing element constructor unwinds the partially built array.
+    static int builtProbes = 0;
+    struct ThrowOnThird {
+        ThrowOnThird() { if (builtProbes == 2) throw std::runtime_error("third"); ++builtProbes; }
+        ~ThrowOnThird() { --builtProbes; }
+    };
+    ink::InkedArena::Arena throwing{};
+    ink::InkedArena::arena_init(&throwing, 4096);
+    bool threw = false;
+    try {
+        ink::InkedArena::arena_new_array<ThrowOnThird>(&throwing, 5);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw && builtProbes == 0 && throwing.finalizers == nullptr);
+    ink::InkedArena::arena_destroy(&throwing);
+
+    // Stats: requested vs used exposes alignment padding; peak survives
+    // resets.
+    ink::InkedArena::Arena counted{};
+    ink::InkedArena::arena_init(&counted, 4096);
+    ink::InkedArena::arena_alloc(&counted, 1, 1);
+    ink::InkedArena::arena_alloc(&counted, 8, 64); // padded up to a 64-byte boundary
+    ink::InkedArena::ArenaStats st = ink::InkedArena::arena_stats(&counted);
+#if INK_ALLOCATOR_STATS
+    CHECK(st.requested == 9);
+    CHECK(st.used == counted.head->offset && st.used > st.requested);
+#else
+    CHECK(st.requested == 0 && st.used == counted.head->offset && st.used > 9);
+#endif
+    CHECK(st.blocks == 1 && st.spare_blocks == 0);
+    CHECK(st.committed >= 4096 && st.reserved == st.committed);
+    for (int i = 0; i < 4; ++i) ink::InkedArena::arena_alloc(&counted, 3000, 8);
+    const size_t highWater = ink::InkedArena::arena_stats(&counted).used;
+    ink::InkedArena::arena_reset(&counted);
+    st = ink::InkedArena::arena_stats(&counted);
+    CHECK(st.requested == 0 && st.used == 0);
+    CHECK(st.peak == highWater);
+    CHECK(st.blocks == 1 && st.spare_blocks >= 1);
+    ink::InkedArena::arena_destroy(&counted);
+}
+
+// ============================================================================
+// ConcurrentArena
+// ============================================================================
+void test_concurrent_arena()
+{
+    SECTION("ConcurrentArena");
+
+    // Thread arenas: blocks go back to the shared recycler on reset/exit
+    // and are picked up by the next thread instead of being remapped.
+    ink::BlockRecycler& recycler = ink::BlockRecycler::global();
+    recycler.trim(0);
+    std::atomic<int> misaligned{0};
+    auto worker = [&] {
+        for (int round = 0; round < 3; ++round) {
+            for (int i = 0; i < 2000; ++i) {
+                u64* p = static_cast<u64*>(ink::ThreadArena::alloc(sizeof(u64) * 4, 32));
+                if (reinterpret_cast<std::uintptr_t>(p) % 32) misaligned++;
+                p[0] = p[3] = static_cast<u64>(i);
+            }
+            ink::ThreadArena::reset();
+        }
+    };
+    std::thread first(worker);
+    first.join();
+    const size_t pooledAfterFirst = recycler.pooledBytes();
+    CHECK(pooledAfterFirst >= recycler.blockSize()); // exit returned everything
+    std::thread second(worker);
+    second.join();
+    CHECK(recycler.pooledBytes() == pooledAfterFirst); // reused, nothing new mapped
+    CHECK(misaligned.load() == 0);
+
+    {
+        ink::ArenaScope scope(ink::ThreadArena::local());
+        CHECK(ink::ThreadArena::alloc(100) != nullptr);
+    }
+    ink::ThreadArena::reset();
+
+    // Generic arena paths on the thread arena (arena_alloc, pmr) draw
+    // from and return to the recycler too, never mapping blocks of their own.
+    {
+        const size_t pooledBefore = recycler.pooledBytes();
+        {
+            ink::ArenaScope scope(ink::ThreadArena::local());
+            ink::ArenaResource resource(ink::ThreadArena::local());
+            std::pmr::vector<u64> values(&resource);
+            for (u64 i = 0; i < 4 * recycler.blockSize() / sizeof(u64); ++i) values.push_back(i);
+            CHECK(recycler.pooledBytes() < pooledBefore || pooledBefore == 0);
+            CHECK(ink::InkedArena::arena_stats(ink::ThreadArena::local()).spare_blocks == 0);
+        }
+        CHECK(ink::InkedArena::arena_stats(ink::ThreadArena::local()).spare_blocks == 0);
+        CHECK(recycler.pooledBytes() >= pooledBefore);
+    }
+    ink::ThreadArena::reset();
+
+    // Any arena can draw on a recycler through its block source.
+    {
+        ink::BlockRecycler pool(4096);
+        ink::InkedArena::Arena a{};
+        ink::InkedArena::arena_init(&a, 4096);
+        a.source = pool.source();
+        bool allocated = true;
+        for (int i = 0; i < 16; ++i) allocated = allocated && ink::InkedArena::arena_alloc(&a, 1024, 8);
+        CHECK(allocated);
+        ink::InkedArena::arena_reset(&a);
+        const size_t pooled = pool.pooledBytes();
+        CHECK(pooled >= 3 * 4096 && ink::InkedArena::arena_stats(&a).spare_blocks == 0);
+        for (int i = 0; i < 16; ++i) allocated = allocated && ink::InkedArena::arena_alloc(&a, 1024, 8);
+        CHECK(allocated && pool.pooledBytes() < pooled);  // reused pooled blocks
+        ink::InkedArena::arena_destroy(&a);
+        CHECK(pool.pooledBytes() > pooled);  // every block, the first one included
+    }
+
+    // Shared arena: concurrent appends never overlap.
+    ink::ConcurrentArena shared(16 * 1024);
+    constexpr int kThreads = 8;
+    constexpr int kPerThread = 5000;
+    std::vector<std::vector<u64*>> results(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < kPerThread; ++i) {
+                u64* p = static_cast<u64*>(shared.alloc(3 * sizeof(u64), 8));
+                p[0] = static_cast<u64>(t);
+                p[1] = static_cast<u64>(i);
+                p[2] = p[0] ^ p[1];
+                results[t].push_back(p);
+            }
+        });
+    }
+    for (std::thread& th : threads) th.join();
+    bool intact = true;
+    for (int t = 0; t < kThreads; ++t) {
+        for (int i = 0; i < kPerThread; ++i) {
+            const u64* p = results[t][i];
+            intact = intact && p[0] == u64(t) && p[1] == u64(i) && p[2] == (u64(t) ^ u64(i));
+        }
+    }
+    CHECK(intact);
+    CHECK(shared.blockCount() > 1);
+    shared.reset();
+    CHECK(shared.blockCount() == 1);
+    CHECK(shared.alloc(64) != nullptr);
+}
+
+// ============================================================================
+// ConcurrentObjectPool
+// ============================================================================
+struct PooledTicket {
+    static inline std::atomic<int> live{0};
+    u64 owner;
+    u64 seq;
+    u64 check;
+    PooledTicket(u64 o, u64 s) : owner(o), seq(s), check(o * 1000003u + s) { live++; }
+    ~PooledTicket() { live--; }
+};
+
+void test_concurrent_objectpool()
+{
+    SECTION("ConcurrentObjectPool");
+
+    ink::ConcurrentObjectPool<PooledTicket, 16> pool(256, 4);
+    CHECK(pool.shardCount() == 4);
+    PooledTicket* a = pool.acquire(1, 2);
+    CHECK(a->check == 1000003u + 2);
+    pool.release(a);
+    CHECK(PooledTicket::live.load() == 0);
+    CHECK(pool.acquire(3, 4) == a); // LIFO within the thread's magazine
+    pool.release(a);
+    {
+        ink::PoolPtr<PooledTicket> t = pool.make(5, 6);
+        CHECK(t.get() == a && PooledTicket::live.load() == 1);
+    }
+    CHECK(PooledTicket::live.load() == 0);
+
+    // Producers acquire, consumers on other threads release: every object
+    // arrives intact and exactly once, and nothing leaks. A semaphore caps
+    // the objects in flight so producers cannot run ahead of the consumers
+    // however the threads are scheduled, which bounds the slots needed.
+    ink::Queue<PooledTicket*> handoff;
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 20000;
+    constexpr int kInFlight = 1024;
+    std::counting_semaphore<kInFlight> inFlight(kInFlight);
+    std::atomic<int> corrupt{0};
+    std::atomic<int> consumed{0};
+    std::vector<std::thread> producers, consumers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&, p] {
+            for (int i = 0; i < kPerProducer; ++i) {
+                inFlight.acquire();
+                handoff.push(pool.acquire(u64(p), u64(i)));
+            }
+        });
+    }
+    for (int c = 0; c < 3; ++c) {
+        consumers.emplace_back([&] {
+            PooledTicket* t = nullptr;
+            while (handoff.wait_and_pop(t)) {
+                if (t->check != t->owner * 1000003u + t->seq) corrupt++;
+                pool.release(t);
+                inFlight.release();
+                consumed++;
+            }
+        });
+    }
+    for (std::thread& th : producers) th.join();
+    handoff.shutdown();
+    for (std::thread& th : consumers) th.join();
+    CHECK(consumed.load() == kProducers * kPerProducer);
+    CHECK(corrupt.load() == 0);
+    CHECK(PooledTicket::live.load() == 0);
+    // In flight, plus what the shards' magazines and one slab can cache
+    CHECK(pool.capacity() <= size_t(4 * kInFlight));
+
+    // One-slot magazines force hundreds of them, spanning several of the
+    // doubling magazine chunks; every slot still comes back exactly once.
+    {
+        ink::ConcurrentObjectPool<u64, 1> singles(1024, 1);
+        std::vector<u64*> held;
+        for (u64 i = 0; i < 1000; ++i) held.push_back(singles.acquire(i));
+        for (u64* p : held) singles.release(p);
+        std::set<u64*> again;
+        for (size_t i = 0; i < held.size(); ++i) again.insert(singles.acquire(0));
+        CHECK(again.size() == held.size() && singles.capacity() == 1024);
+        for (u64* p : again) singles.release(p);
+    }
+}
+
+// ============================================================================
+// SlotMap
+// ============================================================================
+void test_slotmap()
+{
+    SECTION("SlotMap");
+
+    using Map = ink::SlotMap<std::string>;
+    Map map;
+    Map::Handle a = map.insert("alpha");
+    Map::Handle b = map.insert("beta");
+    Map::Handle c = map.insert(3, 'c');
+    CHECK(map.size() == 3);
+    CHECK(*map.get(a) == "alpha" && *map.get(c) == "ccc");
+    CHECK(!Map::Handle{} && !map.contains(Map::Handle{}));
+
+    // Erase moves the last value into the hole; handles stay valid.
+    CHECK(map.erase(a));
+    CHECK(!map.erase(a));
+    CHECK(map.get(a) == nullptr);
+    CHECK(*map.get(b) == "beta" && *map.get(c) == "ccc");
+    CHECK(map.size() == 2 && *map.begin() == "ccc");
+
+    // The freed slot is reused under a new generation: the stale handle
+    // does not alias the new object.
+    Map::Handle d = map.insert("delta");
+    CHECK(d.index == a.index && d.generation != a.generation);
+    CHECK(map.get(a) == nullptr && *map.get(d) == "delta");
+    CHECK(!map.contains(Map::Handle{ d.index, d.generation + 1 }));
+    CHECK(map.handleAt(0) == c);
+
+    // A throwing constructor leaves the map untouched: the free slot is
+    // still there for the next insert.
+    CHECK(map.erase(d));
+    bool threw = false;
+    try { (void)map.insert(std::string::npos, 'x'); } catch (const std::length_error&) { threw = true; }
+    CHECK(threw && map.size() == 2);
+    Map::Handle e = map.insert("echo");
+    CHECK(e.index == d.index && e.generation != d.generation && *map.get(e) == "echo");
+
+    map.clear();
+    CHECK(map.empty() && !map.contains(b) && !map.contains(d));
+
+    // Randomized run against a brute-force model.
+    ink::SlotMap<u64> slots;
+    std::vector<std::pair<ink::SlotMap<u64>::Handle, u64>> live;
+    std::vector<ink::SlotMap<u64>::Handle> dead;
+    u64 rng = 0x9E3779B97F4A7C15ULL;
+    auto next = [&] { rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17; return rng; };
+    bool consistent = true;
+    for (int step = 0; step < 20000; ++step) {
+        if (live.empty() || next() % 3 != 0) {
+            const u64 v = next();
+            live.emplace_back(slots.insert(v), v);
+        } else {
+            const size_t i = next() % live.size();
+            consistent &= slots.erase(live[i].first);
+            dead.push_back(live[i].first);
+            live[i] = live.back();
+            live.pop_back();
+        }
+    }
+    consistent &= slots.size() == live.size();
+    for (auto& [h, v] : live) consistent &= slots.get(h) && *slots.get(h) == v;
+    for (auto& h : dead) consistent &= !slots.contains(h);
+    u64 denseSum = 0, modelSum = 0;
+    for (u64 v : slots) denseSum += v;
+    for (auto& [h, v] : live) modelSum += v;
+    consistent &= denseSum == modelSum;
+    for (size_t i = 0; i < slots.size(); ++i) consistent &= *slots.get(slots.handleAt(i)) == slots.begin()[i];
+    CHECK(consistent);
+}
+
+// ============================================================================
+// CachePadded
+// ============================================================================
+// Runs bump(t) perThread times on each of `threads` threads, all at once
+template<typename Bump>
+void hammer(int threads, int perThread, Bump&& bump)
+{
+    std::atomic<int> ready{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            ready++;
+            while (ready.load() < threads) std::this_thread::yield();
+            for (int i = 0; i < perThread; ++i) bump(t);
+        });
+    }
+    for (std::thread& th : workers) th.join();
+}
+
+void test_cachepadded()
+{
+    SECTION("CachePadded");
+
+    static_assert(alignof(ink::CachePadded<u8>) == ink::kCacheLineSize);
+    static_assert(sizeof(ink::CachePadded<u8>) == ink::kCacheLineSize);
+    static_assert(sizeof(ink::CachePadded<char[ink::kCacheLineSize + 1]>) == 2 * ink::kCacheLineSize);
+    ink::CachePadded<std::atomic<u64>> padded[2];
+    CHECK(reinterpret_cast<std::uintptr_t>(&padded[1]) - reinterpret_cast<std::uintptr_t>(&padded[0]) == ink::kCacheLineSize);
+    ink::CachePadded<std::string> text(std::in_place, 3, 'x');
+    CHECK(*text == "xxx" && text->size() == 3);
+
+    // The one power-of-two rounding helper every ring and shard table uses.
+    CHECK(ink::detail::roundPow2(0) == 1 && ink::detail::roundPow2(1) == 1);
+    CHECK(ink::detail::roundPow2(3) == 4 && ink::detail::roundPow2(64) == 64);
+    const size_t topPow2 = (std::numeric_limits<size_t>::max() >> 1) + 1;
+    CHECK(ink::detail::roundPow2(topPow2) == topPow2);
+    bool overflowThrew = false;
+    try { ink::detail::roundPow2(topPow2 + 1); } catch (const std::bad_alloc&) { overflowThrew = true; }
+    CHECK(overflowThrew);
+
+    // Distinct threads get distinct PerThread shards while they fit.
+    ink::PerThread<int> perThread(8);
+    CHECK(perThread.shardCount() == 8);
+    // Two fresh threads draw consecutive indices, whatever ran before them.
+    int* mine = nullptr;
+    int* theirs = nullptr;
+    bool stable = false;
+    std::thread([&] { mine = &perThread.local(); stable = &perThread.local() == mine; }).join();
+    std::thread([&] { theirs = &perThread.local(); }).join();
+    CHECK(mine != theirs && stable);
+
+    ink::PerCpu<int> perCpu(3);
+    CHECK(perCpu.shardCount() == 4);
+    int cpuShards = 0;
+    perCpu.forEach([&](const int&) { ++cpuShards; });
+    CHECK(cpuShards == 4);
+
+    // Sharded counters lose nothing.
+    const int threads = static_cast<int>(INK_MAX(INK_MIN(std::thread::hardware_concurrency(), 8u), 2u));
+    constexpr int kBumps = 200000;
+    ink::ShardedCounter<> counter;
+    ink::ShardedCounter<ink::PerCpu<std::atomic<u64>>> cpuCounter;
+    hammer(threads, kBumps, [&](int) { counter.add(); cpuCounter.add(2); });
+    CHECK(counter.load() == u64(threads) * kBumps);
+    CHECK(cpuCounter.load() == 2 * u64(threads) * kBumps);
 }
 
 // ============================================================================
@@ -360,6 +1653,83 @@ void test_aligned_allocator()
     alignedVec.resize(8, 1.0f);
     CHECK((reinterpret_cast<std::uintptr_t>(alignedVec.data()) % 32) == 0);
     CHECK(alignedVec.size() == 8);
+
+    // Huge-page policy: large requests are mapped (Explicit falls back to
+    // transparent pages without a hugetlbfs pool), small ones stay on the heap.
+    const ink::PageAllocator::Stats before = ink::PageAllocator::stats();
+    ink::AlignedAllocator<f32, 64, ink::PageAllocator::Explicit> hugeAlloc;
+    const size_t count = (size_t(4) << 20) / sizeof(f32);
+    f32* huge = hugeAlloc.allocate(count);
+    CHECK((reinterpret_cast<std::uintptr_t>(huge) % ink::PageAllocator::kHugePageSize) == 0);
+    huge[0] = 1.0f;
+    huge[count - 1] = 2.0f;
+    const ink::PageAllocator::Stats during = ink::PageAllocator::stats();
+    CHECK(during.hugeBytes + during.advisedBytes + during.smallBytes >=
+          before.hugeBytes + before.advisedBytes + before.smallBytes + (size_t(4) << 20));
+    CHECK(during.hugeBytes > before.hugeBytes || during.explicitFallbacks > before.explicitFallbacks);
+    hugeAlloc.deallocate(huge, count);
+    const ink::PageAllocator::Stats after = ink::PageAllocator::stats();
+    CHECK(after.hugeBytes == before.hugeBytes && after.advisedBytes == before.advisedBytes &&
+          after.smallBytes == before.smallBytes);
+
+    // A request that is an exact huge-page multiple maps exactly that much
+    // (nothing is borrowed past the end), and every byte of it is usable.
+    const size_t exact = ink::PageAllocator::kHugePageSize / sizeof(f32);
+    f32* whole = hugeAlloc.allocate(exact);
+    const ink::PageAllocator::Stats wholeDuring = ink::PageAllocator::stats();
+    CHECK(wholeDuring.hugeBytes + wholeDuring.advisedBytes + wholeDuring.smallBytes ==
+          after.hugeBytes + after.advisedBytes + after.smallBytes + ink::PageAllocator::kHugePageSize);
+    for (size_t i = 0; i < exact; ++i) whole[i] = 3.0f;
+    hugeAlloc.deallocate(whole, exact);
+    const ink::PageAllocator::Stats wholeAfter = ink::PageAllocator::stats();
+    CHECK(wholeAfter.hugeBytes == before.hugeBytes && wholeAfter.advisedBytes == before.advisedBytes &&
+          wholeAfter.smallBytes == before.smallBytes);
+
+    f32* small = hugeAlloc.allocate(16);
+    CHECK(ink::PageAllocator::stats().smallBytes == before.smallBytes);
+    hugeAlloc.deallocate(small, 16);
+
+    // NUMA placement: large buffers are mapped and bound to the requested
+    // node (or the caller's), small ones stay on the heap.
+    const int nodes = ink::PageAllocator::numaNodeCount();
+    const int here = ink::PageAllocator::currentNumaNode();
+    CHECK(nodes >= 1 && here >= 0 && here < nodes);
+    CHECK(ink::PageAllocator::highestInList("0\n") == 0);
+    CHECK(ink::PageAllocator::highestInList("0-3") == 3);
+    CHECK(ink::PageAllocator::highestInList("0,2") == 2);
+    CHECK(ink::PageAllocator::highestInList("0-1,3") == 3);
+    CHECK(ink::PageAllocator::highestInList("4,0-1") == 4);
+    CHECK(ink::PageAllocator::highestInList("") == -1);
+    {
+        using Numa = ink::NumaAllocator<f32, 64>;
+        CHECK(Numa(0) == Numa(0) && Numa(0) != Numa(1));
+        CHECK((ink::NumaAllocator<double, 64>(Numa(0)).node() == 0));
+
+        const ink::PageAllocator::Stats numaBefore = ink::PageAllocator::stats();
+        std::vector<f32, Numa> local(1 << 20, 1.0f, Numa(nodes - 1));
+        CHECK((reinterpret_cast<std::uintptr_t>(local.data()) % ink::PageAllocator::pageSize()) == 0);
+        CHECK(local.back() == 1.0f);
+        const ink::PageAllocator::Stats numaDuring = ink::PageAllocator::stats();
+        CHECK(numaDuring.smallBytes >= numaBefore.smallBytes + (size_t(4) << 20));
+#if defined(__linux__) && defined(SYS_get_mempolicy)
+        if (numaDuring.numaFallbacks == numaBefore.numaFallbacks) {
+            // The range carries the preferred-node policy
+            int mode = -1;
+            unsigned long mask[16] = {};
+            constexpr unsigned long kMpolFAddr = 2;
+            CHECK(syscall(SYS_get_mempolicy, &mode, mask, sizeof(mask) * 8, local.data(), kMpolFAddr) == 0);
+            CHECK(mode == 1 && (mask[0] & (1UL << (nodes - 1))) != 0);
+        }
+#endif
+        std::vector<f32, Numa> tiny(4, 0.0f); // below a page: heap, any node
+        CHECK((reinterpret_cast<std::uintptr_t>(tiny.data()) % 64) == 0);
+        local.clear();
+        local.shrink_to_fit();
+        CHECK(ink::PageAllocator::stats().smallBytes == numaBefore.smallBytes);
+
+        std::vector<f32, ink::NumaAllocator<f32, 64, ink::PageAllocator::Transparent>> huge2(1 << 20);
+        CHECK((reinterpret_cast<std::uintptr_t>(huge2.data()) % ink::PageAllocator::kHugePageSize) == 0);
+    }
 }
 
 // ============================================================================
@@ -503,6 +1873,80 @@ void test_queue()
     q.shutdown();
     waiter.join();
     CHECK(q.is_shutdown());
+
+    // QueueSet: one consumer blocking on queues of different element types.
+    {
+        ink::Queue<int> control;
+        ink::Queue<std::string> data;
+        ink::QueueSet set;
+        const size_t controlIdx = set.add(control);
+        const size_t dataIdx = set.add(data);
+
+        CHECK(!set.try_select().has_value());
+        CHECK(!set.wait_for(std::chrono::milliseconds(10)).has_value());
+
+        // A queue belongs to one set at a time: adding it elsewhere (or
+        // twice) is rejected instead of silently moving it.
+        {
+            ink::QueueSet other;
+            CHECK(other.add(data) == ink::QueueSet::npos);
+            CHECK(set.add(control) == ink::QueueSet::npos);
+            CHECK(other.size() == 0 && set.size() == 2);
+        }
+
+        std::thread producer([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            data.push("payload");
+        });
+        auto ready = set.wait();
+        producer.join();
+        CHECK(ready.has_value() && *ready == dataIdx);
+        std::string payload;
+        CHECK(data.try_pop(payload) && payload == "payload");
+
+        // Fairness: with both queues permanently ready, wait() alternates.
+        for (int i = 0; i < 4; ++i) {
+            control.push(i);
+            data.push("x");
+        }
+        auto first = set.wait();
+        auto second = set.wait();
+        CHECK(first.has_value() && second.has_value() && *first != *second);
+
+        int ctl = 0;
+        while (control.try_pop(ctl)) {}
+        while (data.try_pop(payload)) {}
+
+        // Once every member is shut down and drained, wait() reports nullopt.
+        control.shutdown();
+        CHECK(!set.try_select().has_value());
+        data.push("last");
+        data.shutdown();
+        auto lastReady = set.wait();
+        CHECK(lastReady.has_value() && *lastReady == dataIdx);
+        CHECK(data.try_pop(payload) && payload == "last");
+        CHECK(!set.wait().has_value());
+        CHECK(controlIdx != dataIdx);
+    }
+
+    // add() proceeds while a consumer is blocked in wait(), and wakes it
+    // to scan the new member.
+    {
+        ink::Queue<int> idle;
+        ink::Queue<int> late;
+        ink::QueueSet set;
+        set.add(idle);
+        std::optional<size_t> woke;
+        std::thread consumer([&]() { woke = set.wait(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        late.push(7);
+        const size_t lateIdx = set.add(late);
+        consumer.join();
+        CHECK(lateIdx == 1 && set.size() == 2);
+        CHECK(woke.has_value() && *woke == lateIdx);
+        idle.shutdown();
+        late.shutdown();
+    }
 }
 
 // ============================================================================
@@ -540,6 +1984,100 @@ void test_timerwheel()
 
     u64 next = wheel.timeToNextTickMillis(wheel.getNextTickTime());
     CHECK(next == 0); // already at/after the next tick boundary
+
+    // Per-node timeouts: schedule(n) fires on the (n + 1)-th tick() call,
+    // whatever level the delay starts on.
+    {
+        ink::TimerWheel hier(60, 10);
+        ink::TimerNode a, b, c;
+        hier.schedule(&a, 0);
+        hier.schedule(&b, 100);   // level 1
+        hier.schedule(&c, 5000);  // level 2
+        std::vector<std::pair<ink::TimerNode*, u64>> fired;
+        for (int i = 0; i < 6000; ++i) {
+            const u64 at = hier.now();
+            hier.processExpired([&](ink::TimerNode* n) { fired.emplace_back(n, at); });
+        }
+        CHECK(fired.size() == 3);
+        CHECK(fired.size() == 3 && fired[0].first == &a && fired[0].second == 0);
+        CHECK(fired.size() == 3 && fired[1].first == &b && fired[1].second == 100);
+        CHECK(fired.size() == 3 && fired[2].first == &c && fired[2].second == 5000);
+
+        // Rescheduling moves a node; unlink cancels it on any level.
+        hier.schedule(&a, 70);
+        hier.schedule(&a, 3);
+        hier.schedule(&b, 300000); // level 3
+        hier.unlink(&b);
+        int count = 0;
+        u64 when = 0;
+        for (int i = 0; i < 100; ++i) {
+            const u64 at = hier.now();
+            hier.processExpired([&](ink::TimerNode*) { ++count; when = at; });
+        }
+        CHECK(count == 1 && when == 6000 + 3);
+
+        // Millisecond delays round up to the first tick at or after the
+        // deadline: 35 ms from the last tick boundary is the 4th tick.
+        const u64 base = hier.getNextTickTime() - 10;
+        hier.scheduleAfterMillis(&c, 35, base);
+        CHECK(c.expires == hier.now() + 3);
+        hier.scheduleAfterMillis(&c, 0, base);
+        CHECK(c.expires == hier.now());
+        hier.unlink(&c);
+    }
+
+    // Randomized run against a brute-force model (expiry tick per node),
+    // mixing delays on every level, reschedules and cancels.
+    {
+        ink::TimerWheel hier(60, 1);
+        constexpr int kNodes = 512;
+        std::vector<ink::TimerNode> timers(kNodes);
+        std::vector<i64> expected(kNodes, -1); // -1 = not scheduled
+        u64 rng = 0x2545F4914F6CDD1DULL;
+        auto next = [&] { rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17; return rng; };
+        const u64 spans[] = { 64, 4096, 262144, 1u << 20 };
+        bool exact = true;
+        int firedCount = 0;
+        for (int step = 0; step < 400000; ++step) {
+            if (next() % 8 == 0) {
+                const size_t i = next() % kNodes;
+                if (next() % 4 == 0) {
+                    hier.unlink(&timers[i]);
+                    expected[i] = -1;
+                } else {
+                    const u64 delay = next() % spans[next() % 4];
+                    hier.schedule(&timers[i], delay);
+                    expected[i] = static_cast<i64>(hier.now() + delay);
+                }
+            }
+            const u64 at = hier.now();
+            hier.processExpired([&](ink::TimerNode* n) {
+                const size_t i = static_cast<size_t>(n - timers.data());
+                exact &= expected[i] == static_cast<i64>(at);
+                expected[i] = -1;
+                ++firedCount;
+            });
+        }
+        // Anything still due before now should have fired
+        for (i64 e : expected) exact &= e == -1 || e >= static_cast<i64>(hier.now());
+        CHECK(exact);
+        CHECK(firedCount > 1000);
+    }
+
+    // Delays past the wheel's range are parked and re-filed until due.
+    {
+        ink::TimerWheel hier(60, 1);
+        ink::TimerNode far;
+        const u64 delay = ink::TimerWheel::kMaxTicks + 12345;
+        hier.schedule(&far, delay);
+        u64 firedAt = 0;
+        int count = 0;
+        while (hier.now() <= delay + 1) {
+            const u64 at = hier.now();
+            hier.processExpired([&](ink::TimerNode*) { firedAt = at; ++count; });
+        }
+        CHECK(count == 1 && firedAt == delay);
+    }
 }
 
 // ============================================================================
@@ -917,8 +2455,15 @@ int main(int argc, char** argv)
     test_inkogger();
     test_inkassert();
     test_ringbuffer();
+    test_spscringbuffer();
     test_objectpool();
+    test_typedringbuffer();
+    test_broadcastring();
     test_arena_allocator();
+    test_concurrent_arena();
+    test_concurrent_objectpool();
+    test_slotmap();
+    test_cachepadded();
     test_aligned_allocator();
     test_threadpool();
     test_workerthread();